@@ -0,0 +1,40 @@
+#include "bench_common.h"
+#include "../src/amount_kernels.h"
+
+#include <cstdint>
+
+namespace {
+
+// split_amounts over a 1M-row amount column, once per path the CPU supports.
+void split_amount_paths() {
+    const int rows_count = 1000000;
+    const int passes = 200;
+
+    std::vector<std::int32_t> amounts;
+    amounts.reserve(rows_count);
+    for (int i = 0; i < rows_count; ++i)
+        amounts.push_back((i % 10 == 0) ? 250000 : -(500 + i % 7000));
+
+    std::printf("  detected: %s\n", simd_level_to_string(detected_simd_level()));
+    Amount_split expected = split_amounts(Simd_level::scalar, amounts.data(), amounts.size());
+    for (Simd_level level : {Simd_level::scalar, Simd_level::sse2, Simd_level::avx2}) {
+        if (level > detected_simd_level())
+            continue;
+        std::int64_t checksum = 0;
+        Bench_timer timer;
+        for (int pass = 0; pass < passes; ++pass) {
+            Amount_split split = split_amounts(level, amounts.data(), amounts.size());
+            checksum += split.money_in - split.money_out;
+        }
+        double seconds = timer.elapsed_seconds();
+        char label[64];
+        std::snprintf(label, sizeof(label), "split_amounts (%s)", simd_level_to_string(level));
+        bench_report(label, static_cast<long long>(rows_count) * passes, seconds);
+        if (checksum != (expected.money_in - expected.money_out) * passes)
+            std::fprintf(stderr, "  %s checksum mismatch\n", simd_level_to_string(level));
+    }
+}
+
+} // namespace
+
+BENCHMARK_CASE("kernels/split_amounts", split_amount_paths);
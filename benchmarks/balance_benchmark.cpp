@@ -0,0 +1,71 @@
+#include "bench_common.h"
+#include "../src/storage.h"
+#include "../src/core_logic.h"
+#include "../src/helpers.h"
+
+#include <cstdint>
+#include <ctime>
+
+namespace {
+
+// Net-worth history: balances at 120 month starts for each of 50 accounts, through SQL and
+// through the cached rows' running totals.
+void balance_history() {
+    const int accounts_count = 50;
+    const int rows_per_account = 20000;
+    const int months = 120;
+    std::string path = bench_db_path("balance");
+    std::time_t first_day = 1388534400; // 2014-01-01
+
+    std::vector<int> account_ids;
+    {
+        Storage store(path, Storage_options::fast_interactive());
+        for (int a = 0; a < accounts_count; ++a) {
+            Account acc("Account " + std::to_string(a), Account_type::checking, 100000, true);
+            store.save_account_info(acc);
+            account_ids.push_back(acc.read_account_id_in_DB());
+
+            std::vector<Transaction_info> rows;
+            rows.reserve(rows_per_account);
+            for (int i = 0; i < rows_per_account; ++i) {
+                Transaction_info trans = create_transaction_info(
+                    account_ids.back(), (i % 8 == 0) ? 300000 : -(1000 + i % 9000), Transaction_type::Want,
+                    Transaction_category_need::Other, Transaction_category_want::Shopping, "Card purchase", "", 0, 0);
+                trans.ymd = first_day + static_cast<std::time_t>(i) * (months * 30LL * 86400 / rows_per_account);
+                rows.push_back(std::move(trans));
+            }
+            store.save_transactions_batch(account_ids.back(), rows);
+        }
+    }
+
+    std::vector<std::time_t> month_starts;
+    for (int m = 1; m <= months; ++m)
+        month_starts.push_back(first_day + static_cast<std::time_t>(m) * 30 * 86400);
+
+    Storage store(path);
+    store.load_accounts();
+    std::int64_t checksum_sql = 0;
+    {
+        Bench_timer timer;
+        for (int account_id : account_ids)
+            for (std::int64_t balance : store.get_balances_at(account_id, month_starts))
+                checksum_sql += balance;
+        bench_report("get_balances_at (SQL)", static_cast<long long>(accounts_count) * months, timer.elapsed_seconds(), "queries");
+    }
+
+    store.load_all_transactions();
+    std::int64_t checksum_cached = 0;
+    {
+        Bench_timer timer;
+        for (int account_id : account_ids)
+            for (std::int64_t balance : store.get_balances_at(account_id, month_starts))
+                checksum_cached += balance;
+        bench_report("get_balances_at (cached)", static_cast<long long>(accounts_count) * months, timer.elapsed_seconds(), "queries");
+    }
+    if (checksum_sql != checksum_cached)
+        std::fprintf(stderr, "  checksum mismatch: %lld vs %lld\n", static_cast<long long>(checksum_sql), static_cast<long long>(checksum_cached));
+}
+
+} // namespace
+
+BENCHMARK_CASE("balance/history", balance_history);
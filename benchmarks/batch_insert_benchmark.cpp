@@ -0,0 +1,67 @@
+#include "bench_common.h"
+#include "../src/storage.h"
+#include "../src/core_logic.h"
+#include "../src/helpers.h"
+
+#include <ctime>
+
+namespace {
+
+std::vector<Transaction_info> make_import_rows(int account_id, int count) {
+    std::vector<Transaction_info> rows;
+    rows.reserve(count);
+    std::time_t day = 1704067200; // 2024-01-01
+    for (int i = 0; i < count; ++i) {
+        int amount = (i % 10 == 0) ? 250000 : -(500 + i % 7000);
+        Transaction_info trans = create_transaction_info(
+            account_id, amount, amount > 0 ? Transaction_type::Income : Transaction_type::Need,
+            Transaction_category_need::Food, Transaction_category_want::Other,
+            "Imported row", "", 0, 0);
+        trans.ymd = day + (i / 50) * 86400;
+        rows.push_back(std::move(trans));
+    }
+    return rows;
+}
+
+int create_account(Storage& store) {
+    Account acc("Import", Account_type::checking, 0, true);
+    store.save_account_info(acc);
+    return acc.read_account_id_in_DB();
+}
+
+// Baseline: one BEGIN IMMEDIATE/COMMIT per row, which is what an import did before the batch API.
+void per_row_insert() {
+    const int rows_count = 1000;
+    Storage store(bench_db_path("per_row"));
+    int account_id = create_account(store);
+    std::vector<Transaction_info> rows = make_import_rows(account_id, rows_count);
+
+    Bench_timer timer;
+    for (Transaction_info& trans : rows) {
+        store.save_transaction_info(account_id, trans);
+    }
+    bench_report("save_transaction_info (per row)", rows_count, timer.elapsed_seconds());
+}
+
+void batch_insert() {
+    for (int rows_count : {10000, 100000, 1000000}) {
+        Storage store(bench_db_path("batch_" + std::to_string(rows_count)));
+        int account_id = create_account(store);
+        std::vector<Transaction_info> rows = make_import_rows(account_id, rows_count);
+
+        Bench_timer timer;
+        std::optional<Storage_changes> changes = store.save_transactions_batch(account_id, rows);
+        double seconds = timer.elapsed_seconds();
+        if (!changes) {
+            std::fprintf(stderr, "  batch of %d rows failed\n", rows_count);
+            continue;
+        }
+        std::string label = "save_transactions_batch (" + std::to_string(rows_count) + ")";
+        bench_report(label.c_str(), rows_count, seconds);
+    }
+}
+
+} // namespace
+
+BENCHMARK_CASE("batch_insert/per_row", per_row_insert);
+BENCHMARK_CASE("batch_insert/batch", batch_insert);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Small helpers shared by the benchmark files. Each benchmark registers itself with
+// BENCHMARK_CASE and is run by bench_main.cpp, optionally filtered by name on the command line.
+
+struct Benchmark_case {
+    const char* name;
+    std::function<void()> run;
+};
+
+std::vector<Benchmark_case>& benchmark_registry();
+
+// number of global operator new calls so far, on every thread (src/allocation_counter.cpp counts them)
+long long bench_allocation_count();
+
+struct Benchmark_registrar {
+    Benchmark_registrar(const char* name, std::function<void()> run) {
+        benchmark_registry().push_back({name, std::move(run)});
+    }
+};
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+#define BENCHMARK_CASE(name, fn) \
+    static Benchmark_registrar BENCH_CONCAT(bench_registrar_, __LINE__)(name, fn)
+
+class Bench_timer {
+public:
+    Bench_timer() : start(std::chrono::steady_clock::now()) {}
+
+    double elapsed_seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+// Returns a path in the temp directory with any leftover database (and WAL/journal files) removed.
+inline std::string bench_db_path(const std::string& name) {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / ("pbudget_bench_" + name + ".db");
+    for (const char* suffix : {"", "-wal", "-shm", "-journal"}) {
+        std::filesystem::remove(path.string() + suffix);
+    }
+    return path.string();
+}
+
+inline void bench_report(const char* label, long long items, double seconds, const char* unit = "rows") {
+    double per_second = seconds > 0.0 ? items / seconds : 0.0;
+    std::printf("  %-40s %10lld %s  %9.3f s  %12.0f %s/s\n", label, items, unit, seconds, per_second, unit);
+}
@@ -0,0 +1,33 @@
+#include "bench_common.h"
+#include "../src/allocation_counter.h"
+
+#include <cstring>
+
+long long bench_allocation_count() {
+    return total_allocation_count();
+}
+
+std::vector<Benchmark_case>& benchmark_registry() {
+    static std::vector<Benchmark_case> registry;
+    return registry;
+}
+
+// Usage: BENCHBudgetApp [name-filter]
+// Runs every registered benchmark whose name contains the filter (all of them if none is given).
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : "";
+    int ran = 0;
+    for (const Benchmark_case& bench : benchmark_registry()) {
+        if (std::strstr(bench.name, filter) == nullptr) {
+            continue;
+        }
+        std::printf("%s\n", bench.name);
+        bench.run();
+        ++ran;
+    }
+    if (ran == 0) {
+        std::fprintf(stderr, "No benchmark matches '%s'\n", filter);
+        return 1;
+    }
+    return 0;
+}
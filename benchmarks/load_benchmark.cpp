@@ -0,0 +1,59 @@
+#include "bench_common.h"
+#include "../src/storage.h"
+#include "../src/core_logic.h"
+#include "../src/helpers.h"
+
+#include <ctime>
+
+namespace {
+
+// Startup cost of reading a large ledger back: load_all_transactions (no notes) and the three
+// get_monthly_information projections over the whole range.
+void load_ledger() {
+    const int rows_count = 1000000;
+    std::string path = bench_db_path("load");
+    std::time_t first_day = 1704067200; // 2024-01-01
+    int account_id = 0;
+    {
+        Storage store(path);
+        Account acc("Ledger", Account_type::checking, 0, true);
+        store.save_account_info(acc);
+        account_id = acc.read_account_id_in_DB();
+
+        std::vector<Transaction_info> rows;
+        rows.reserve(rows_count);
+        for (int i = 0; i < rows_count; ++i) {
+            Transaction_info trans = create_transaction_info(
+                account_id, -(100 + i % 5000), Transaction_type::Want,
+                Transaction_category_need::Other, Transaction_category_want::Entertainment,
+                "Card purchase - grocery store", "Imported from the bank export; reference number and merchant details follow", 0, 0);
+            trans.ymd = first_day + (i / 1000) * 86400;
+            rows.push_back(std::move(trans));
+        }
+        store.save_transactions_batch(account_id, rows);
+    }
+
+    Storage store(path);
+    {
+        long long allocations_before = bench_allocation_count();
+        Bench_timer timer;
+        store.load_all_transactions();
+        bench_report("load_all_transactions", rows_count, timer.elapsed_seconds());
+        std::printf("  %-40s %10lld allocations, %.1f MiB cached\n", "", bench_allocation_count() - allocations_before,
+            store.get_transactions(account_id).memory_bytes() / (1024.0 * 1024.0));
+    }
+
+    std::time_t last_day = first_day + (rows_count / 1000 + 1) * 86400;
+    struct Projection { const char* label; Transaction_columns columns; };
+    for (Projection projection : {Projection{"get_monthly_information (summary)", Transaction_columns::summary},
+                                  Projection{"get_monthly_information (list)", Transaction_columns::list},
+                                  Projection{"get_monthly_information (full)", Transaction_columns::full}}) {
+        Bench_timer timer;
+        std::vector<Transaction_info> rows = store.get_monthly_information(account_id, first_day, last_day, projection.columns);
+        bench_report(projection.label, static_cast<long long>(rows.size()), timer.elapsed_seconds());
+    }
+}
+
+} // namespace
+
+BENCHMARK_CASE("load/ledger", load_ledger);
@@ -0,0 +1,122 @@
+#include "bench_common.h"
+#include "../src/transaction_store.h"
+#include "../src/helpers.h"
+#include "../src/amount_kernels.h"
+
+#include <cstdint>
+#include <ctime>
+
+namespace {
+
+size_t vector_memory_bytes(const std::vector<Transaction_info>& rows) {
+    size_t bytes = rows.capacity() * sizeof(Transaction_info);
+    const size_t inline_capacity = std::string().capacity();
+    for (const Transaction_info& trans : rows) {
+        if (trans.transaction_name.capacity() > inline_capacity)
+            bytes += trans.transaction_name.capacity() + 1;
+        if (trans.note.capacity() > inline_capacity)
+            bytes += trans.note.capacity() + 1;
+    }
+    return bytes;
+}
+
+// Money in/out over a date window, the scan behind the monthly summaries, against the old
+// vector<Transaction_info> layout, the columnar store, and the store's date index.
+void scan_layouts() {
+    const int rows_count = 1000000;
+    const int passes = 20;
+    std::time_t first_day = 1704067200;
+
+    // a few recurring payees, as in a real ledger
+    const char* payees[] = {"Card purchase at a local merchant", "Rent - monthly standing order",
+                            "Groceries - weekly supermarket shop", "Salary from employer payroll"};
+
+    std::vector<Transaction_info> rows;
+    Account_transactions columns;
+    long long allocations_before = bench_allocation_count();
+    rows.reserve(rows_count);
+    for (int i = 0; i < rows_count; ++i) {
+        Transaction_info trans = create_transaction_info(
+            1, (i % 10 == 0) ? 250000 : -(500 + i % 7000), Transaction_type::Want,
+            Transaction_category_need::Other, Transaction_category_want::Shopping,
+            payees[i % 4], "", 0, 0);
+        trans.transaction_id = i + 1;
+        trans.ymd = first_day + (i / 1000) * 86400;
+        rows.push_back(std::move(trans));
+    }
+    long long rows_allocations = bench_allocation_count() - allocations_before;
+
+    allocations_before = bench_allocation_count();
+    columns.reserve(rows_count);
+    for (const Transaction_info& trans : rows)
+        columns.push_back(trans);
+    long long columns_allocations = bench_allocation_count() - allocations_before;
+    std::time_t window_start = first_day + 30 * 86400;
+    std::time_t window_end = first_day + 900 * 86400;
+
+    std::int64_t checksum_rows = 0;
+    Bench_timer rows_timer;
+    for (int pass = 0; pass < passes; ++pass) {
+        std::int64_t money_in = 0, money_out = 0;
+        for (const Transaction_info& trans : rows) {
+            if (trans.ymd < window_start || trans.ymd >= window_end)
+                continue;
+            if (trans.transaction_amount > 0)
+                money_in += trans.transaction_amount;
+            else
+                money_out -= trans.transaction_amount;
+        }
+        checksum_rows += money_in - money_out;
+    }
+    bench_report("scan vector<Transaction_info>", static_cast<long long>(rows_count) * passes, rows_timer.elapsed_seconds());
+
+    std::int64_t checksum_columns = 0;
+    Bench_timer columns_timer;
+    for (int pass = 0; pass < passes; ++pass) {
+        const std::vector<int>& amounts = columns.amounts();
+        const std::vector<std::time_t>& dates = columns.dates();
+        std::int64_t money_in = 0, money_out = 0;
+        for (size_t i = 0; i < amounts.size(); ++i) {
+            if (dates[i] < window_start || dates[i] >= window_end)
+                continue;
+            if (amounts[i] > 0)
+                money_in += amounts[i];
+            else
+                money_out -= amounts[i];
+        }
+        checksum_columns += money_in - money_out;
+    }
+    bench_report("scan Account_transactions columns", static_cast<long long>(rows_count) * passes, columns_timer.elapsed_seconds());
+
+    std::int64_t checksum_index = 0;
+    Bench_timer index_timer;
+    for (int pass = 0; pass < passes; ++pass) {
+        Account_transactions::Date_range window = columns.in_date_range(window_start, window_end);
+        Amount_split split = split_amounts(window.amounts.data(), window.amounts.size());
+        checksum_index += split.money_in - split.money_out;
+    }
+    bench_report("range Account_transactions date index", static_cast<long long>(rows_count) * passes, index_timer.elapsed_seconds());
+
+    // running totals: two binary searches per query however wide the window is
+    const int total_queries = 1000000;
+    std::int64_t checksum_totals = 0;
+    Bench_timer totals_timer;
+    for (int query = 0; query < total_queries; ++query) {
+        Amount_split split = columns.totals_in_date_range(window_start, window_end);
+        checksum_totals += split.money_in - split.money_out;
+    }
+    bench_report("totals_in_date_range", total_queries, totals_timer.elapsed_seconds(), "queries");
+    if (checksum_totals / total_queries != checksum_index / passes)
+        std::fprintf(stderr, "  running totals mismatch\n");
+
+    if (checksum_rows != checksum_columns || checksum_rows != checksum_index)
+        std::fprintf(stderr, "  checksum mismatch: %lld vs %lld vs %lld\n", static_cast<long long>(checksum_rows),
+            static_cast<long long>(checksum_columns), static_cast<long long>(checksum_index));
+
+    std::printf("  vector<Transaction_info>     %8.1f MiB  %10lld allocations\n", vector_memory_bytes(rows) / (1024.0 * 1024.0), rows_allocations);
+    std::printf("  Account_transactions         %8.1f MiB  %10lld allocations\n", columns.memory_bytes() / (1024.0 * 1024.0), columns_allocations);
+}
+
+} // namespace
+
+BENCHMARK_CASE("store/scan_layouts", scan_layouts);
@@ -0,0 +1,111 @@
+#include "bench_common.h"
+#include "../src/transaction_table_index.h"
+#include "../src/helpers.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+namespace {
+
+// Re-sorting and re-filtering the All Transactions table over 1M rows: the old approach (copy the
+// rows, std::sort the copies) against Transaction_table_index, whose permutations are built once
+// and then only walked. Each index figure is per query, so it can be read against a 16 ms frame.
+void table_queries() {
+    const int rows_count = 1000000;
+    const int passes = 20;
+    std::time_t first_day = 1704067200;
+    const char* payees[] = {"Card purchase at a local merchant", "Rent - monthly standing order",
+                            "Groceries - weekly supermarket shop", "Salary from employer payroll",
+                            "Bookshop", "Bank fee"};
+
+    Account_transactions rows;
+    rows.reserve(rows_count);
+    for (int i = 0; i < rows_count; ++i) {
+        Transaction_info trans = create_transaction_info(
+            1, (i % 10 == 0) ? 250000 : -(500 + (i * 7919) % 70000), static_cast<Transaction_type>(i % 8),
+            static_cast<Transaction_category_need>(i % 7), static_cast<Transaction_category_want>(i % 6),
+            payees[i % 6], "", 0, 0);
+        trans.transaction_id = i + 1;
+        trans.ymd = first_day + ((i * 31) % 1000) * 86400;   // dates out of id order
+        Transaction_row row{trans.transaction_id, trans.account_id, trans.transaction_amount, trans.type_of_transaction,
+                            trans.transaction_category_need, trans.transaction_category_want, 0, 0, trans.ymd,
+                            trans.transaction_name, trans.note, true};
+        rows.append(row);
+    }
+    rows.index_dates();
+
+    {
+        Bench_timer timer;
+        std::vector<Transaction_info> copies;
+        copies.reserve(rows.size());
+        for (const Transaction_row row : rows)
+            copies.push_back(row.to_info());
+        std::sort(copies.begin(), copies.end(), [](const Transaction_info& a, const Transaction_info& b) {
+            return a.transaction_amount != b.transaction_amount ? a.transaction_amount < b.transaction_amount
+                                                                : a.transaction_id < b.transaction_id;
+        });
+        bench_report("copy + std::sort by amount", rows_count, timer.elapsed_seconds());
+    }
+
+    Transaction_table_index index;
+    Transaction_query query;
+    {
+        Bench_timer timer;
+        for (Transaction_sort_column column : {Transaction_sort_column::Name, Transaction_sort_column::Amount,
+                                               Transaction_sort_column::Type, Transaction_sort_column::Category}) {
+            query.column = column;
+            index.rows_for(rows, query);
+        }
+        bench_report("build 4 permutations (once)", rows_count, timer.elapsed_seconds());
+    }
+
+    std::size_t checksum = 0;
+    {
+        Bench_timer timer;
+        for (int pass = 0; pass < passes; ++pass) {
+            query.column = static_cast<Transaction_sort_column>(pass % 5);
+            query.descending = pass % 2 == 0;
+            checksum += index.rows_for(rows, query).front();
+        }
+        double seconds = timer.elapsed_seconds();
+        bench_report("re-sort (per query)", static_cast<long long>(rows_count) * passes, seconds);
+        std::printf("  %-40s %10.3f ms\n", "  average re-sort", seconds * 1000.0 / passes);
+    }
+    {
+        Bench_timer timer;
+        for (int pass = 0; pass < passes; ++pass) {
+            query.filter = Transaction_filter{};
+            query.filter.type = static_cast<Transaction_type>(pass % 8);
+            query.filter.min_amount = -30000 - pass;
+            query.filter.max_amount = 100000;
+            query.filter.start = first_day + (pass % 10) * 86400;
+            query.filter.end = first_day + 700 * 86400;
+            query.filter.text = pass % 2 ? "shop" : "fee";
+            checksum += index.rows_for(rows, query).size();
+        }
+        double seconds = timer.elapsed_seconds();
+        bench_report("re-filter (per query)", static_cast<long long>(rows_count) * passes, seconds);
+        std::printf("  %-40s %10.3f ms\n", "  average re-filter", seconds * 1000.0 / passes);
+    }
+    {
+        const int inserts = 100;
+        Bench_timer timer;
+        for (int i = 0; i < inserts; ++i) {
+            Transaction_info trans = create_transaction_info(1, -1234, Transaction_type::Want,
+                Transaction_category_need::Other, Transaction_category_want::Travel, "Train tickets", "", 0, 0);
+            trans.transaction_id = rows_count + 1 + i;
+            trans.ymd = first_day + 500 * 86400;
+            rows.push_back(trans);
+            checksum += index.rows_for(rows, query).size();
+        }
+        double seconds = timer.elapsed_seconds();
+        bench_report("insert + re-query (incremental)", inserts, seconds, "inserts");
+    }
+    std::printf("  checksum %zu\n", checksum);
+}
+
+} // namespace
+
+BENCHMARK_CASE("table/sort_filter", table_queries);
@@ -0,0 +1,313 @@
+#include "bench_common.h"
+#include "../src/allocation_counter.h"
+#include "../src/app_controller.h"
+#include "../src/core_logic.h"
+#include "../src/future_app_state.h"
+#include "../src/helpers.h"
+#include "../src/storage.h"
+#include "../src/UI/right_panel.h"
+#include "../src/UI/sidebar_panel.h"
+#include "../external/imgui/imgui.h"
+#include "../external/imgui/imgui_internal.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+// Headless UI frame benchmark: draw_sidebar and draw_right_panel against a synthetic in-memory
+// Storage, with ImGui running without a window or GPU (fixed display size, a renderer that only
+// acknowledges font textures). A script clicks through the UI the way a user would: open the
+// wallet, select each account, page months back and forth, open All Transactions, scroll, re-sort
+// and close it. Every frame is timed with Frame_profiler, the same numbers the profiler overlay
+// shows, and p50/p99 frame CPU time is reported at the end.
+//
+// Usage: UIBENCHBudgetApp [frames] [transactions-per-account] [max-p99-ms]
+// With max-p99-ms the exit status is 1 if p99 frame time goes over it, so CI can gate on it.
+
+namespace {
+
+// Items are found by label through the ImGui test engine hooks (IMGUI_ENABLE_TEST_ENGINE is set
+// for this target): ItemAdd reports each item's rectangle, ItemInfo its label right after. Table
+// headers report no label, so ItemAdd names them after their column.
+struct Item_finder {
+    const char* target = nullptr;   // label to look for this frame
+    ImGuiID last_added = 0;
+    ImRect last_rect;
+    bool found = false;
+    ImRect rect;
+};
+
+Item_finder finder;
+
+} // namespace
+
+void ImGuiTestEngineHook_ItemAdd(ImGuiContext* ctx, ImGuiID id, const ImRect& bb, const ImGuiLastItemData*) {
+    finder.last_added = id;
+    finder.last_rect = bb;
+    ImGuiTable* table = ctx->CurrentTable;
+    if (finder.target && table && table->IsInsideRow && (table->RowFlags & ImGuiTableRowFlags_Headers)
+        && std::strcmp(ImGui::TableGetColumnName(table->CurrentColumn), finder.target) == 0) {
+        finder.found = true;
+        finder.rect = bb;
+    }
+}
+
+void ImGuiTestEngineHook_ItemInfo(ImGuiContext*, ImGuiID id, const char* label, ImGuiItemStatusFlags) {
+    if (finder.target && id == finder.last_added && label && std::strcmp(label, finder.target) == 0) {
+        finder.found = true;
+        finder.rect = finder.last_rect;
+    }
+}
+
+void ImGuiTestEngineHook_Log(ImGuiContext*, const char*, ...) {}
+
+const char* ImGuiTestEngine_FindItemDebugLabel(ImGuiContext*, ImGuiID) {
+    return nullptr;
+}
+
+namespace {
+
+const int account_count = 6;
+const int history_months = 24;
+
+std::string account_name(int i) {
+    return "Account " + std::to_string(i + 1);
+}
+
+// accounts with transactions spread over the last history_months months, so paging back from
+// the current month always lands on data
+void fill_storage(Storage& store, int rows_per_account) {
+    const char* payees[] = {"Card purchase at a local merchant", "Rent - monthly standing order",
+                            "Groceries - weekly supermarket shop", "Salary from employer payroll",
+                            "Bookshop", "Bank fee"};
+    const std::time_t now = std::time(nullptr);
+    const std::time_t span = static_cast<std::time_t>(history_months) * 30 * 86400;
+    for (int a = 0; a < account_count; ++a) {
+        Account acc(account_name(a), a % 3 == 2 ? Account_type::savings : Account_type::checking, 100000, true);
+        store.save_account_info(acc);
+        const int account_id = acc.read_account_id_in_DB();
+
+        std::vector<Transaction_info> rows;
+        rows.reserve(rows_per_account);
+        for (int i = 0; i < rows_per_account; ++i) {
+            Transaction_info trans = create_transaction_info(
+                account_id, (i % 10 == 0) ? 250000 : -(500 + (i * 7919) % 70000), static_cast<Transaction_type>(i % 8),
+                static_cast<Transaction_category_need>(i % 7), static_cast<Transaction_category_want>(i % 6),
+                payees[(i + a) % 6], "", 0, 0);
+            trans.ymd = now - span + (span / rows_per_account) * i;
+            rows.push_back(std::move(trans));
+        }
+        store.save_transactions_batch(account_id, rows);
+    }
+    store.load_all_transactions();
+}
+
+// one scripted step: hover the item, press, release (a click lands on release), or just let frames
+// pass with the mouse over the last item, optionally scrolling
+struct Step {
+    enum Kind { Click, Wait, Scroll } kind;
+    std::string label;
+    int frames = 1;
+};
+
+std::vector<Step> build_script() {
+    std::vector<Step> script;
+    script.push_back({Step::Click, "Open wallet"});
+    for (int a = 0; a < account_count; ++a) {
+        script.push_back({Step::Click, account_name(a)});
+        script.push_back({Step::Wait, "", 10});
+        for (int m = 0; m < 6; ++m)
+            script.push_back({Step::Click, "<"});
+        for (int m = 0; m < 3; ++m)
+            script.push_back({Step::Click, ">"});
+        script.push_back({Step::Click, "View all transactions"});
+        script.push_back({Step::Wait, "", 5});
+        script.push_back({Step::Scroll, "", 20});
+        script.push_back({Step::Click, "Type"});   // table headers: re-sort
+        script.push_back({Step::Click, "Name"});
+        script.push_back({Step::Scroll, "", 10});
+        script.push_back({Step::Click, "Close"});
+        script.push_back({Step::Wait, "", 5});
+    }
+    script.push_back({Step::Click, account_name(account_count - 1)});   // deselect
+    script.push_back({Step::Click, "Open wallet"});                     // and close the wallet
+    return script;
+}
+
+// acknowledges every font texture request, which is all a renderer has to do for ImGui to go on
+void null_render(ImDrawData* draw_data) {
+    if (!draw_data->Textures)
+        return;
+    for (ImTextureData* tex : *draw_data->Textures) {
+        if (tex->Status == ImTextureStatus_WantCreate || tex->Status == ImTextureStatus_WantUpdates) {
+            tex->SetTexID(static_cast<ImTextureID>(1));
+            tex->SetStatus(ImTextureStatus_OK);
+        } else if (tex->Status == ImTextureStatus_WantDestroy) {
+            tex->SetTexID(ImTextureID_Invalid);
+            tex->SetStatus(ImTextureStatus_Destroyed);
+        }
+    }
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const int rows_per_account = argc > 2 ? std::atoi(argv[2]) : 20000;
+    const double max_p99_ms = argc > 3 ? std::atof(argv[3]) : 0.0;
+    if (frames <= 0 || rows_per_account <= 0) {
+        std::fprintf(stderr, "Usage: %s [frames] [transactions-per-account] [max-p99-ms]\n", argv[0]);
+        return 2;
+    }
+
+    Storage store(":memory:");
+    {
+        Bench_timer timer;
+        fill_storage(store, rows_per_account);
+        std::printf("ui/frames\n");
+        bench_report("synthetic storage", static_cast<long long>(account_count) * rows_per_account, timer.elapsed_seconds());
+    }
+
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    GImGui->TestEngineHookItems = true;
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.DisplaySize = ImVec2(1600.f, 900.f);
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
+
+    // the app's sizes at a DPI scale of 1, with the built-in font instead of the TTF it loads
+    ImFontConfig base_font;
+    base_font.SizePixels = 18.0f;
+    io.FontDefault = io.Fonts->AddFontDefault(&base_font);
+    ImFontConfig large_font;
+    large_font.SizePixels = 24.0f;
+    ImFont* font_large = io.Fonts->AddFontDefault(&large_font);
+    ImGuiStyle& style = ImGui::GetStyle();
+    style.FramePadding = ImVec2(12.f, 8.f);
+    style.ItemSpacing = ImVec2(10.f, 8.f);
+    style.ItemInnerSpacing = ImVec2(8.f, 6.f);
+    style.WindowPadding = ImVec2(14.f, 14.f);
+
+    App_state state;
+    state.dpi_scale = 1.0f;
+    Controller controller(state, store);
+    state.wallet.publish(store.load_accounts());
+    state.profiler.set_allocation_counter(&allocation_count);
+    store.set_statement_observer(&Frame_profiler::observe_statement, &state.profiler);
+
+    const std::vector<Step> script = build_script();
+    size_t step_index = 0;
+    int step_frame = 0;   // frames spent in the current step
+    ImVec2 mouse(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.5f);
+    int clicks = 0;
+    int missed = 0;
+
+    std::vector<double> frame_ms;
+    std::vector<double> allocations;
+    long long statements = 0;
+    frame_ms.reserve(frames);
+    allocations.reserve(frames);
+
+    for (int frame = 0; frame < frames; ++frame) {
+        const Step& step = script[step_index];
+        bool step_done = false;
+        io.AddMousePosEvent(mouse.x, mouse.y);   // before any button event, so the press lands here
+        finder.target = nullptr;
+        if (step.kind == Step::Click) {
+            // frame 0 finds the item and moves onto it, 1 presses, 2 releases
+            if (step_frame == 0) {
+                finder.target = step.label.c_str();
+                finder.found = false;
+            } else if (step_frame == 1) {
+                io.AddMouseButtonEvent(0, true);
+            } else {
+                io.AddMouseButtonEvent(0, false);
+                clicks++;
+                step_done = true;
+            }
+        } else {
+            if (step.kind == Step::Scroll)
+                io.AddMouseWheelEvent(0.f, -1.f);
+            step_done = step_frame + 1 >= step.frames;
+        }
+        io.DeltaTime = 1.0f / 60.0f;
+
+        state.profiler.begin_frame();
+        ImGui::NewFrame();
+        ImGui::SetNextWindowPos(ImVec2(0.f, 0.f));
+        ImGui::SetNextWindowSize(io.DisplaySize);
+        ImGui::Begin("My Budget App", nullptr,
+            ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove
+            | ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoScrollbar);
+        const float left_pane_width = io.DisplaySize.x * 0.25f - style.ItemSpacing.x * 0.5f;
+        const float right_pane_width = io.DisplaySize.x * 0.75f - style.ItemSpacing.x * 0.5f;
+        {
+            Profile_scope scope(&state.profiler, "draw_sidebar");
+            draw_sidebar(state, controller, left_pane_width);
+        }
+        ImGui::SameLine();
+        {
+            Profile_scope scope(&state.profiler, "draw_right_panel");
+            draw_right_panel(state, controller, right_pane_width, font_large);
+        }
+        ImGui::End();
+        {
+            Profile_scope scope(&state.profiler, "render");
+            ImGui::Render();
+            null_render(ImGui::GetDrawData());
+        }
+        state.profiler.end_frame();
+
+        const Frame_profile& profile = state.profiler.frame(state.profiler.history_size() - 1);
+        frame_ms.push_back(profile.frame_ms);
+        allocations.push_back(static_cast<double>(profile.allocations));
+        statements += profile.statement_count;
+
+        if (finder.target) {
+            if (finder.found) {
+                mouse = finder.rect.GetCenter();
+            } else {
+                missed++;   // not on screen (e.g. behind a closed popup); skip the click
+                step_done = true;
+            }
+        }
+        if (step_done) {
+            step_index = (step_index + 1) % script.size();
+            step_frame = 0;
+        } else {
+            step_frame++;
+        }
+    }
+
+    store.set_statement_observer(nullptr, nullptr);
+    ImGui::DestroyContext();
+
+    const double p50 = percentile(frame_ms, 0.50);
+    const double p99 = percentile(frame_ms, 0.99);
+    std::printf("  %-40s %10d frames, %d clicks, %d targets not found\n", "scripted session", frames, clicks, missed);
+    std::printf("  %-40s %10.3f ms\n", "frame CPU p50", p50);
+    std::printf("  %-40s %10.3f ms\n", "frame CPU p99", p99);
+    std::printf("  %-40s %10.3f ms\n", "frame CPU max", *std::max_element(frame_ms.begin(), frame_ms.end()));
+    std::printf("  %-40s %10.0f / %.0f\n", "allocations per frame p50 / p99", percentile(allocations, 0.50),
+        percentile(allocations, 0.99));
+    std::printf("  %-40s %10.2f\n", "SQL statements per frame", static_cast<double>(statements) / frames);
+
+    if (max_p99_ms > 0.0 && p99 > max_p99_ms) {
+        std::fprintf(stderr, "p99 frame time %.3f ms is over the %.3f ms budget\n", p99, max_p99_ms);
+        return 1;
+    }
+    return 0;
+}
@@ -4,10 +4,12 @@
 #include "../helpers.h"
 #include "transaction_form.h"
 #include "latest_transactions_table.h"
+#include "all_transactions_view.h"
 
 void draw_account_view_panel(App_state& state, Controller& controller, float right_pane_width, ImFont* font_large)
 {
-    const auto& acc = state.wallet[state.selected_account_index];
+    std::shared_ptr<const Wallet_snapshot> wallet = state.wallet.snapshot();
+    const auto& acc = (*wallet)[state.selected_account_index];
 
     // Top row: account name + balance (left), monthly summary (right)
     const float summary_offset = (right_pane_width * 0.45f);
@@ -57,7 +59,11 @@ void draw_account_view_panel(App_state& state, Controller& controller, float rig
 
 
 
-    specific_range_of_transactions_info range_info = controller.get_monthly_summary(acc.account_id, month_start, month_end);
+    specific_range_of_transactions_info range_info;
+    {
+        Profile_scope scope(&state.profiler, "get_monthly_summary");
+        range_info = controller.get_monthly_summary(acc.account_id, month_start, month_end);
+    }
 
 
 
@@ -94,6 +100,7 @@ void draw_account_view_panel(App_state& state, Controller& controller, float rig
 
     if (state.create_transaction_open)
     {
+        Profile_scope scope(&state.profiler, "draw_transaction_form");
         draw_transaction_form(state, controller);
     }
     else
@@ -103,38 +110,12 @@ void draw_account_view_panel(App_state& state, Controller& controller, float rig
             state.selected_account_index = -1;
     }
 
-    draw_latest_transactions_table(state, controller);
-
-    ImGui::Spacing();
-    static bool all_txn_modal_open = true;
-    if (ImGui::Button("View all transactions"))
     {
-        all_txn_modal_open = true;
-        ImGui::OpenPopup("All Transactions");
-    }
-    if (ImGui::BeginPopupModal("All Transactions", &all_txn_modal_open, ImGuiWindowFlags_AlwaysAutoResize))
-    {
-        const auto& all_txns = controller.get_transactions(acc.account_id);
-        if (all_txns.empty())
-            ImGui::TextUnformatted("No transactions.");
-        else
-        {
-            ImGui::BeginChild("TxnList", ImVec2(450 * s, 350 * s), true);
-            for (int i = static_cast<int>(all_txns.size()) - 1; i >= 0; --i)
-            {
-                const auto& t = all_txns[i];
-                char date_buf[32];
-                std::strftime(date_buf, sizeof(date_buf), "%Y-%m-%d %H:%M", std::localtime(&t.ymd));
-                const float dollars = cents_to_dollars(t.transaction_amount);
-                const char* sign = t.transaction_amount >= 0 ? "+" : "";
-                ImGui::Text("%s  %s%.2f  %s  %s", t.transaction_name.c_str(), sign, dollars, transaction_type_to_string(t.type_of_transaction), date_buf);
-                if (!t.note.empty())
-                    ImGui::TextWrapped("  %s", t.note.c_str());
-            }
-            ImGui::EndChild();
-        }
-        if (ImGui::Button("Close"))
-            ImGui::CloseCurrentPopup();
-        ImGui::EndPopup();
+        Profile_scope scope(&state.profiler, "draw_latest_transactions_table");
+        draw_latest_transactions_table(state, controller);
     }
+
+    ImGui::Spacing();
+    Profile_scope scope(&state.profiler, "draw_all_transactions_view");
+    draw_all_transactions_view(state, controller, acc.account_id);
 }
@@ -0,0 +1,204 @@
+#include "all_transactions_view.h"
+#include "../future_app_state.h"
+#include "../../external/imgui/imgui.h"
+#include "../../external/imgui/misc/cpp/imgui_stdlib.h"
+#include "../helpers.h"
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace
+{
+    // combo index 0 is "any"; index i is the enum value i - 1
+    const char* type_item(void*, int index)
+    {
+        return index == 0 ? "Any type" : transaction_type_to_string(static_cast<Transaction_type>(index - 1));
+    }
+
+    const char* need_category_item(void*, int index)
+    {
+        return index == 0 ? "Any category" : transaction_category_need_to_string(static_cast<Transaction_category_need>(index - 1));
+    }
+
+    const char* want_category_item(void*, int index)
+    {
+        return index == 0 ? "Any category" : transaction_category_want_to_string(static_cast<Transaction_category_want>(index - 1));
+    }
+
+    //local midnight of a "YYYY-MM-DD" date, or nothing if the text is not one
+    std::optional<std::time_t> parse_day(const std::string& text)
+    {
+        std::tm day{};
+        if (std::sscanf(text.c_str(), "%d-%d-%d", &day.tm_year, &day.tm_mon, &day.tm_mday) != 3)
+            return std::nullopt;
+        day.tm_year -= 1900;
+        day.tm_mon -= 1;
+        day.tm_isdst = -1;
+        std::time_t t = std::mktime(&day);
+        if (t == static_cast<std::time_t>(-1))
+            return std::nullopt;
+        return t;
+    }
+
+    std::optional<std::time_t> day_after(std::optional<std::time_t> day)
+    {
+        if (!day)
+            return std::nullopt;
+        std::tm next = *std::localtime(&*day);
+        next.tm_mday += 1;
+        next.tm_isdst = -1;
+        return std::mktime(&next);
+    }
+
+    //the filter row above the table; edits go straight into `filter`
+    void draw_filters(Transaction_filter& filter, float s)
+    {
+        static int type_index = 0;
+        static int category_index = 0;
+        static bool use_amount = false;
+        static float amount_range[2] = {0.0f, 0.0f};
+        static std::string from_day;
+        static std::string to_day;
+
+        ImGui::SetNextItemWidth(220.f * s);
+        ImGui::InputTextWithHint("##NameFilter", "Search names...", &filter.text);
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(160.f * s);
+        if (ImGui::Combo("##TypeFilter", &type_index, type_item, nullptr, 9))
+            category_index = 0;
+        filter.type = type_index > 0 ? std::optional<Transaction_type>(static_cast<Transaction_type>(type_index - 1)) : std::nullopt;
+
+        filter.need_category.reset();
+        filter.want_category.reset();
+        if (filter.type == Transaction_type::Need || filter.type == Transaction_type::Want)
+        {
+            const bool need = filter.type == Transaction_type::Need;
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(150.f * s);
+            ImGui::Combo("##CategoryFilter", &category_index, need ? need_category_item : want_category_item, nullptr, need ? 9 : 8);
+            if (category_index > 0 && need)
+                filter.need_category = static_cast<Transaction_category_need>(category_index - 1);
+            else if (category_index > 0)
+                filter.want_category = static_cast<Transaction_category_want>(category_index - 1);
+        }
+
+        ImGui::Checkbox("Amount", &use_amount);
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(200.f * s);
+        ImGui::InputFloat2("##AmountFilter", amount_range, "%.2f");
+        filter.min_amount.reset();
+        filter.max_amount.reset();
+        if (use_amount)
+        {
+            filter.min_amount = static_cast<int>(std::lround(amount_range[0] * 100.0));
+            filter.max_amount = static_cast<int>(std::lround(amount_range[1] * 100.0));
+        }
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(110.f * s);
+        ImGui::InputTextWithHint("##FromDay", "From YYYY-MM-DD", &from_day);
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(110.f * s);
+        ImGui::InputTextWithHint("##ToDay", "To YYYY-MM-DD", &to_day);
+        filter.start = parse_day(from_day);
+        filter.end = day_after(parse_day(to_day));   // the "to" day is included
+    }
+}
+
+void draw_all_transactions_view(App_state& state, Controller& controller, int account_id)
+{
+    static bool modal_open = true;
+    static int selected_transaction_id = -1;
+    static Transaction_query query;
+    if (ImGui::Button("View all transactions"))
+    {
+        modal_open = true;
+        selected_transaction_id = -1;
+        ImGui::OpenPopup("All Transactions");
+    }
+    if (!ImGui::BeginPopupModal("All Transactions", &modal_open, ImGuiWindowFlags_AlwaysAutoResize))
+        return;
+
+    const float s = state.dpi_scale;
+    const Account_transactions& rows = controller.get_transactions(account_id);
+    if (rows.empty())
+        ImGui::TextUnformatted("No transactions.");
+    else
+    {
+        draw_filters(query.filter, s);
+        std::span<const Transaction_text> text = controller.get_transaction_text(account_id);
+        const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY
+            | ImGuiTableFlags_Sortable;
+        if (ImGui::BeginTable("AllTransactions", 5, flags, ImVec2(680.f * s, 350.f * s)))
+        {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch, 0.0f, static_cast<ImGuiID>(Transaction_sort_column::Name));
+            ImGui::TableSetupColumn("Amount", ImGuiTableColumnFlags_WidthFixed, 90.0f * s, static_cast<ImGuiID>(Transaction_sort_column::Amount));
+            ImGui::TableSetupColumn("Type", ImGuiTableColumnFlags_WidthFixed, 110.0f * s, static_cast<ImGuiID>(Transaction_sort_column::Type));
+            ImGui::TableSetupColumn("Category", ImGuiTableColumnFlags_WidthFixed, 110.0f * s, static_cast<ImGuiID>(Transaction_sort_column::Category));
+            ImGui::TableSetupColumn("Date", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_DefaultSort
+                | ImGuiTableColumnFlags_PreferSortDescending, 120.0f * s, static_cast<ImGuiID>(Transaction_sort_column::Date));
+            ImGui::TableHeadersRow();
+
+            if (ImGuiTableSortSpecs* sort_specs = ImGui::TableGetSortSpecs())
+            {
+                if (sort_specs->SpecsDirty && sort_specs->SpecsCount > 0)
+                {
+                    query.column = static_cast<Transaction_sort_column>(sort_specs->Specs[0].ColumnUserID);
+                    query.descending = sort_specs->Specs[0].SortDirection == ImGuiSortDirection_Descending;
+                }
+                sort_specs->SpecsDirty = false;
+            }
+
+            // a permutation walk over a cached bitmap; recomputed only when the query or the rows change
+            std::span<const std::uint32_t> order = controller.query_transactions(account_id, query);
+
+            // only the rows in view are submitted, so the cost per frame does not grow with the account
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(order.size()));
+            while (clipper.Step())
+            {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+                {
+                    const std::uint32_t row = order[i];
+                    const Transaction_row t = rows[row];
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::PushID(t.transaction_id);
+                    if (ImGui::Selectable("##row", selected_transaction_id == t.transaction_id, ImGuiSelectableFlags_SpanAllColumns))
+                        selected_transaction_id = t.transaction_id;
+                    ImGui::PopID();
+                    ImGui::SameLine();
+                    ImGui::TextUnformatted(t.transaction_name.data(), t.transaction_name.data() + t.transaction_name.size());
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(text[row].amount);
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(text[row].type);
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(text[row].category);
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(text[row].date);
+                }
+            }
+            ImGui::EndTable();
+            ImGui::TextDisabled("%d of %d transactions", static_cast<int>(order.size()), static_cast<int>(rows.size()));
+        }
+
+        // notes are not loaded with the list; fetch the selected row's the first time it is shown
+        if (selected_transaction_id >= 0 && rows.find(selected_transaction_id) != rows.size())
+        {
+            std::string_view note = controller.get_transaction_note(account_id, selected_transaction_id);
+            if (note.empty())
+                ImGui::TextDisabled("No note");
+            else
+                ImGui::TextWrapped("%s", note.data());
+        }
+        else
+            ImGui::TextDisabled("Select a transaction to see its note");
+    }
+    if (ImGui::Button("Close"))
+        ImGui::CloseCurrentPopup();
+    ImGui::EndPopup();
+}
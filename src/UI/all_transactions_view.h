@@ -0,0 +1,8 @@
+#pragma once
+#include "../future_app_state.h"
+#include "../app_controller.h"
+
+// "View all transactions" button and its modal: the account's rows in a clipped table that only
+// draws the rows in view, sortable by any column (newest first by default) and filtered by name,
+// type, category, amount and date
+void draw_all_transactions_view(App_state& state, Controller& controller, int account_id);
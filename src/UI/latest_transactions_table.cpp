@@ -1,7 +1,7 @@
 #include "latest_transactions_table.h"
 #include "../future_app_state.h"
 #include "../../external/imgui/imgui.h"
-#include "../helpers.h"
+#include <span>
 
 
 void draw_latest_transactions_table(App_state& state, Controller& controller)
@@ -9,14 +9,18 @@ void draw_latest_transactions_table(App_state& state, Controller& controller)
     ImGui::Separator();
     ImGui::Spacing();
     ImGui::Text("Latest transactions");
-    const auto& acc = state.wallet[state.selected_account_index];
+    std::shared_ptr<const Wallet_snapshot> wallet = state.wallet.snapshot();
+    const auto& acc = (*wallet)[state.selected_account_index];
     const auto& txns = controller.get_transactions(acc.account_id);
+    std::span<const Transaction_text> text = controller.get_transaction_text(acc.account_id);
     const int n = static_cast<int>(txns.size());
     const int show_count = std::min(10, n);
     if (show_count == 0)
         ImGui::TextUnformatted("No transactions yet.");
     else
     {
+        // deleting shrinks txns, so defer it until the table is done iterating
+        int pending_delete_id = -1;
         if (ImGui::BeginTable("LatestTransactions", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
         {
             ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch);
@@ -27,22 +31,17 @@ void draw_latest_transactions_table(App_state& state, Controller& controller)
             ImGui::TableHeadersRow();
             for (int i = 0; i < show_count; ++i)
             {
-                const auto& t = txns[n - 1 - i];
+                const int row = n - 1 - i;
+                const auto& t = txns[row];
                 ImGui::TableNextRow();
                 ImGui::TableNextColumn();
-                ImGui::TextUnformatted(t.transaction_name.c_str());
+                ImGui::TextUnformatted(t.transaction_name.data(), t.transaction_name.data() + t.transaction_name.size());
                 ImGui::TableNextColumn();
-                char amount_buf[24];
-                const float dollars = cents_to_dollars(t.transaction_amount);
-                const char* sign = t.transaction_amount >= 0 ? "+" : "";
-                std::snprintf(amount_buf, sizeof(amount_buf), "%s%.2f", sign, dollars);
-                ImGui::TextUnformatted(amount_buf);
+                ImGui::TextUnformatted(text[row].amount);
                 ImGui::TableNextColumn();
-                ImGui::TextUnformatted(transaction_type_to_string(t.type_of_transaction));
+                ImGui::TextUnformatted(text[row].type);
                 ImGui::TableNextColumn();
-                char date_buf[32];
-                std::strftime(date_buf, sizeof(date_buf), "%Y-%m-%d %H:%M", std::localtime(&t.ymd));
-                ImGui::TextUnformatted(date_buf);
+                ImGui::TextUnformatted(text[row].date);
                 ImGui::TableNextColumn();
                 ImGui::PushID(t.transaction_id);
                 ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.7f, 0.2f, 0.2f, 1.0f));
@@ -50,12 +49,14 @@ void draw_latest_transactions_table(App_state& state, Controller& controller)
                 ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.8f, 0.25f, 0.25f, 1.0f));
                 if (ImGui::Button("x"))
                 {
-                    controller.delete_transaction(t.transaction_id, acc.account_id);
+                    pending_delete_id = t.transaction_id;
                 }
                 ImGui::PopStyleColor(3);
                 ImGui::PopID();
             }
             ImGui::EndTable();
         }
+        if (pending_delete_id >= 0)
+            controller.delete_transaction(pending_delete_id, acc.account_id);
     }
 }
\ No newline at end of file
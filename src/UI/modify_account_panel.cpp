@@ -7,7 +7,8 @@
 void draw_modify_account_panel(App_state& state, Controller& controller)
 {
     ImGuiIO& io = ImGui::GetIO();
-    const auto& acc = state.wallet[state.modify_account_index];
+    std::shared_ptr<const Wallet_snapshot> wallet = state.wallet.snapshot();
+    const auto& acc = (*wallet)[state.modify_account_index];
     static std::string modify_account_name;
     static float modify_balance_float = 0.f;
     static int modify_type_combo = 0;
@@ -0,0 +1,117 @@
+#include "profiler_overlay.h"
+#include "../future_app_state.h"
+#include "../../external/imgui/imgui.h"
+#include <cfloat>
+#include <string>
+
+namespace
+{
+    float frame_ms_at(void* profiler, int index)
+    {
+        return static_cast<float>(static_cast<Frame_profiler*>(profiler)->frame(static_cast<size_t>(index)).frame_ms);
+    }
+
+    float statements_at(void* profiler, int index)
+    {
+        return static_cast<float>(static_cast<Frame_profiler*>(profiler)->frame(static_cast<size_t>(index)).statement_count);
+    }
+
+    float allocations_at(void* profiler, int index)
+    {
+        return static_cast<float>(static_cast<Frame_profiler*>(profiler)->frame(static_cast<size_t>(index)).allocations);
+    }
+}
+
+void draw_profiler_overlay(App_state& state)
+{
+    if (!state.profiler_open)
+        return;
+    static std::string dump_message;
+
+    Frame_profiler& profiler = state.profiler;
+    const float s = state.dpi_scale;
+    const ImGuiViewport* viewport = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + viewport->WorkSize.x - 10.f * s, viewport->WorkPos.y + 10.f * s),
+        ImGuiCond_FirstUseEver, ImVec2(1.f, 0.f));
+    ImGui::SetNextWindowBgAlpha(0.9f);
+    if (!ImGui::Begin("Profiler", &state.profiler_open, ImGuiWindowFlags_AlwaysAutoResize))
+    {
+        ImGui::End();
+        return;
+    }
+
+    const int frames = static_cast<int>(profiler.history_size());
+    if (frames == 0)
+    {
+        ImGui::TextUnformatted("No frames recorded yet.");
+        ImGui::End();
+        return;
+    }
+
+    // the last complete frame; the one being drawn now is still open
+    const Frame_profile& last = profiler.frame(profiler.history_size() - 1);
+    double worst_ms = 0.0, total_ms = 0.0;
+    for (int i = 0; i < frames; ++i)
+    {
+        const double ms = profiler.frame(static_cast<size_t>(i)).frame_ms;
+        total_ms += ms;
+        worst_ms = ms > worst_ms ? ms : worst_ms;
+    }
+    ImGui::Text("Frame %lld: %.2f ms CPU (avg %.2f, worst %.2f over %d)", last.frame_number, last.frame_ms,
+        total_ms / frames, worst_ms, frames);
+    ImGui::Text("SQL: %d statements, %.3f ms", last.statement_count, last.sql_ms);
+    ImGui::Text("Allocations: %lld", last.allocations);
+
+    const ImVec2 graph_size(320.f * s, 50.f * s);
+    ImGui::PlotLines("ms", frame_ms_at, &profiler, frames, 0, nullptr, 0.0f, FLT_MAX, graph_size);
+    ImGui::PlotHistogram("SQL", statements_at, &profiler, frames, 0, nullptr, 0.0f, FLT_MAX, graph_size);
+    ImGui::PlotHistogram("allocs", allocations_at, &profiler, frames, 0, nullptr, 0.0f, FLT_MAX, graph_size);
+
+    if (ImGui::BeginTable("ProfilerSections", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+    {
+        ImGui::TableSetupColumn("Section", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("ms", ImGuiTableColumnFlags_WidthFixed, 70.f * s);
+        ImGui::TableSetupColumn("calls", ImGuiTableColumnFlags_WidthFixed, 45.f * s);
+        ImGui::TableHeadersRow();
+        for (size_t i = 0; i < last.section_count; ++i)
+        {
+            const Frame_profile::Section& section = last.sections[i];
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            const float indent = section.depth * 12.f * s;
+            if (indent > 0.f)
+                ImGui::Indent(indent);
+            ImGui::TextUnformatted(section.name);
+            if (indent > 0.f)
+                ImGui::Unindent(indent);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", section.ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%d", section.calls);
+        }
+        ImGui::EndTable();
+    }
+
+    if (last.statement_count > 0 && ImGui::TreeNode("Statements", "Statements (%d)", last.statement_count))
+    {
+        const int listed = last.statement_count < static_cast<int>(Frame_profile::max_statements)
+            ? last.statement_count : static_cast<int>(Frame_profile::max_statements);
+        for (int i = 0; i < listed; ++i)
+            ImGui::Text("%7.3f ms  %s", last.statements[i].ms, last.statements[i].sql);
+        if (last.statement_count > listed)
+            ImGui::TextDisabled("... %d more", last.statement_count - listed);
+        ImGui::TreePop();
+    }
+
+    if (ImGui::Button("Dump to file"))
+    {
+        const char* path = "frame_profile.txt";
+        dump_message = profiler.dump(path) ? std::string("Wrote ") + path : std::string("Could not write ") + path;
+    }
+    if (!dump_message.empty())
+    {
+        ImGui::SameLine();
+        ImGui::TextUnformatted(dump_message.c_str());
+    }
+    ImGui::End();
+}
@@ -0,0 +1,6 @@
+#pragma once
+#include "../future_app_state.h"
+
+// Floating window over the app while state.profiler_open: the last frame's CPU time per panel,
+// SQL statements and allocations, graphs of the recent history, and a button to dump it to a file
+void draw_profiler_overlay(App_state& state);
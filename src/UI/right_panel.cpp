@@ -11,11 +11,20 @@ void draw_right_panel(App_state& state, Controller& controller, float right_pane
     ImGui::BeginChild("RightPane", ImVec2(right_pane_width, 0), true);
 
     if (state.new_account_open)
+    {
+        Profile_scope scope(&state.profiler, "draw_create_account_panel");
         draw_create_account_panel(state, controller);
+    }
     else if (state.modify_account_index >= 0 && state.modify_account_index < (int)state.wallet.size())
+    {
+        Profile_scope scope(&state.profiler, "draw_modify_account_panel");
         draw_modify_account_panel(state, controller);
+    }
     else if (state.selected_account_index >= 0 && state.selected_account_index < (int)state.wallet.size())
+    {
+        Profile_scope scope(&state.profiler, "draw_account_view_panel");
         draw_account_view_panel(state, controller, right_pane_width, font_large);
+    }
     else
     {
         ImGui::Text("Welcome to MyBudget!");
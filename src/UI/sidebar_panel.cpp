@@ -42,10 +42,11 @@ Sidebar_result draw_sidebar(App_state& state, Controller& controller, float left
         ImGui::Text("Accounts");
         const float settings_btn_w = 36.f * state.dpi_scale;
         const float account_btn_h = ImGui::GetFrameHeight();
-        for (int i = 0; i < (int)state.wallet.size(); ++i)
+        std::shared_ptr<const Wallet_snapshot> wallet = state.wallet.snapshot();
+        for (int i = 0; i < (int)wallet->size(); ++i)
         {
             ImGui::PushID(i);
-            const auto& acc = state.wallet[i];
+            const auto& acc = (*wallet)[i];
             const char* account_name = acc.account_name.c_str();
             bool is_selected = (state.selected_account_index == i);
             const float btn_w = left_pane_width - ImGui::GetStyle().WindowPadding.x * 2 - (settings_btn_w + ImGui::GetStyle().ItemSpacing.x);
@@ -89,6 +90,9 @@ Sidebar_result draw_sidebar(App_state& state, Controller& controller, float left
         if (ImGui::Button(exit_lbl))
             result.exit_requested = true;
     }
+    ImGui::Checkbox("Profiler (F1)", &state.profiler_open);
+    ImGui::TextDisabled("Frames: %lld rendered, %lld skipped",
+        state.frame_pacing.frames_rendered, state.frame_pacing.frames_skipped);
     ImGui::EndChild();
 
     return result;
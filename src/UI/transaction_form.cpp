@@ -4,10 +4,12 @@
 #include "../../external/imgui/misc/cpp/imgui_stdlib.h"
 #include "../helpers.h"
 #include "../app_controller.h"
+#include <utility>
 
 void draw_transaction_form(App_state& state, Controller& controller)
 {
-    const auto& acc = state.wallet[state.selected_account_index];
+    std::shared_ptr<const Wallet_snapshot> wallet = state.wallet.snapshot();
+    const auto& acc = (*wallet)[state.selected_account_index];
     ImGui::Separator();
     ImGui::Text("New Transaction");
     ImGui::Spacing();
@@ -37,18 +39,18 @@ void draw_transaction_form(App_state& state, Controller& controller)
         input_transaction_type = Transaction_type::Internal_transfer;
 
         std::string preview = (transfer_target_wallet_index >= 0 &&
-                               transfer_target_wallet_index < static_cast<int>(state.wallet.size()) &&
+                               transfer_target_wallet_index < static_cast<int>(wallet->size()) &&
                                transfer_target_wallet_index != state.selected_account_index)
-            ? state.wallet[transfer_target_wallet_index].account_name
+            ? (*wallet)[transfer_target_wallet_index].account_name
             : "Select account...";
 
         if (ImGui::BeginCombo("Transfer to##transfer_target", preview.c_str()))
         {
-            for (int i = 0; i < static_cast<int>(state.wallet.size()); i++)
+            for (int i = 0; i < static_cast<int>(wallet->size()); i++)
             {
                 if (i == state.selected_account_index) continue;
                 bool is_selected = (transfer_target_wallet_index == i);
-                if (ImGui::Selectable(state.wallet[i].account_name.c_str(), is_selected))
+                if (ImGui::Selectable((*wallet)[i].account_name.c_str(), is_selected))
                 {
                     transfer_target_wallet_index = i;
                 }
@@ -99,19 +101,19 @@ void draw_transaction_form(App_state& state, Controller& controller)
         if (transaction_mode == 2)
         {
             bool valid_target = transfer_target_wallet_index >= 0 &&
-                                transfer_target_wallet_index < static_cast<int>(state.wallet.size()) &&
+                                transfer_target_wallet_index < static_cast<int>(wallet->size()) &&
                                 transfer_target_wallet_index != state.selected_account_index;
             if (valid_target)
             {
                 Transaction_info trans_info;
                 trans_info.transaction_amount = input_int_transaction_amount;
                 trans_info.type_of_transaction = Transaction_type::Internal_transfer;
-                trans_info.transaction_name = input_transaction_name;
-                trans_info.note = input_optional_description;
+                trans_info.transaction_name = std::move(input_transaction_name);
+                trans_info.note = std::move(input_optional_description);
                 trans_info.ymd = std::time(nullptr);
 
                 int from_id = acc.account_id;
-                int to_id = state.wallet[transfer_target_wallet_index].account_id;
+                int to_id = (*wallet)[transfer_target_wallet_index].account_id;
                 controller.create_internal_transfer(from_id, to_id, trans_info);
 
                 input_transaction_name.clear();
@@ -129,7 +131,7 @@ void draw_transaction_form(App_state& state, Controller& controller)
 
             Transaction_info trans_info = create_transaction_info(acc.account_id, transaction_amount_stored, input_transaction_type,
                                                                 input_transaction_category_need, input_transaction_category_want,
-                                                                input_transaction_name, input_optional_description, account_previous_amount,
+                                                                std::move(input_transaction_name), std::move(input_optional_description), account_previous_amount,
                                                                 account_new_amount);
 
             controller.create_transaction(acc.account_id, trans_info);
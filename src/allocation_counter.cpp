@@ -0,0 +1,39 @@
+#include "allocation_counter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    thread_local long long allocations = 0;
+    std::atomic<long long> all_allocations{0};
+}
+
+long long allocation_count()
+{
+    return allocations;
+}
+
+long long total_allocation_count()
+{
+    return all_allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    all_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// Heap allocations made through operator new. allocation_counter.cpp replaces the global operator
+// new/delete to count them; the app, the tests and both benchmark targets link it, so nothing else
+// may define another replacement.
+
+// by the calling thread since it started, so a UI frame's count leaves out the writer thread and
+// the pooled readers
+long long allocation_count();
+// by every thread since the program started
+long long total_allocation_count();
@@ -0,0 +1,182 @@
+#include "amount_kernels.h"
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define PBUDGET_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    template <typename T>
+    Amount_split split_scalar(const T* amounts, size_t count)
+    {
+        Amount_split split;
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::int64_t amount = amounts[i];
+            split.money_in += std::max<std::int64_t>(amount, 0);
+            split.money_out -= std::min<std::int64_t>(amount, 0);
+        }
+        return split;
+    }
+
+#ifdef PBUDGET_X86_KERNELS
+    //sign mask of each 32-bit lane splits it into a positive and a non-positive part; the mask is also
+    //the upper half of the non-positive part, so unpacking against it sign-extends that part to 64 bits
+    __attribute__((target("sse2")))
+    Amount_split split_sse2(const std::int32_t* amounts, size_t count)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i in = zero, out = zero;
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(amounts + i));
+            __m128i negative = _mm_srai_epi32(v, 31);
+            __m128i pos = _mm_andnot_si128(negative, v);
+            __m128i neg = _mm_and_si128(negative, v);
+            in = _mm_add_epi64(in, _mm_unpacklo_epi32(pos, zero));
+            in = _mm_add_epi64(in, _mm_unpackhi_epi32(pos, zero));
+            out = _mm_sub_epi64(out, _mm_unpacklo_epi32(neg, negative));
+            out = _mm_sub_epi64(out, _mm_unpackhi_epi32(neg, negative));
+        }
+        alignas(16) std::int64_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), in);
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes + 2), out);
+        Amount_split tail = split_scalar(amounts + i, count - i);
+        return Amount_split{lanes[0] + lanes[1] + tail.money_in, lanes[2] + lanes[3] + tail.money_out};
+    }
+
+    //SSE2 has no 64-bit compare: broadcast the sign of each lane's high dword instead
+    __attribute__((target("sse2")))
+    Amount_split split_sse2(const std::int64_t* amounts, size_t count)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i in = zero, out = zero;
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(amounts + i));
+            __m128i negative = _mm_shuffle_epi32(_mm_srai_epi32(v, 31), _MM_SHUFFLE(3, 3, 1, 1));
+            in = _mm_add_epi64(in, _mm_andnot_si128(negative, v));
+            out = _mm_sub_epi64(out, _mm_and_si128(negative, v));
+        }
+        alignas(16) std::int64_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), in);
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes + 2), out);
+        Amount_split tail = split_scalar(amounts + i, count - i);
+        return Amount_split{lanes[0] + lanes[1] + tail.money_in, lanes[2] + lanes[3] + tail.money_out};
+    }
+
+    //same scheme as the SSE2 path, eight lanes at a time (unpack works per 128-bit half, which is
+    //fine for a sum)
+    __attribute__((target("avx2")))
+    Amount_split split_avx2(const std::int32_t* amounts, size_t count)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i in = zero, out = zero;
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(amounts + i));
+            __m256i negative = _mm256_srai_epi32(v, 31);
+            __m256i pos = _mm256_andnot_si256(negative, v);
+            __m256i neg = _mm256_and_si256(negative, v);
+            in = _mm256_add_epi64(in, _mm256_unpacklo_epi32(pos, zero));
+            in = _mm256_add_epi64(in, _mm256_unpackhi_epi32(pos, zero));
+            out = _mm256_sub_epi64(out, _mm256_unpacklo_epi32(neg, negative));
+            out = _mm256_sub_epi64(out, _mm256_unpackhi_epi32(neg, negative));
+        }
+        alignas(32) std::int64_t lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), in);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes + 4), out);
+        Amount_split tail = split_scalar(amounts + i, count - i);
+        return Amount_split{lanes[0] + lanes[1] + lanes[2] + lanes[3] + tail.money_in,
+                            lanes[4] + lanes[5] + lanes[6] + lanes[7] + tail.money_out};
+    }
+
+    __attribute__((target("avx2")))
+    Amount_split split_avx2(const std::int64_t* amounts, size_t count)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i in = zero, out = zero;
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(amounts + i));
+            __m256i negative = _mm256_cmpgt_epi64(zero, v);
+            in = _mm256_add_epi64(in, _mm256_andnot_si256(negative, v));
+            out = _mm256_sub_epi64(out, _mm256_and_si256(negative, v));
+        }
+        alignas(32) std::int64_t lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), in);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes + 4), out);
+        Amount_split tail = split_scalar(amounts + i, count - i);
+        return Amount_split{lanes[0] + lanes[1] + lanes[2] + lanes[3] + tail.money_in,
+                            lanes[4] + lanes[5] + lanes[6] + lanes[7] + tail.money_out};
+    }
+#endif
+
+    Simd_level detect_simd_level()
+    {
+#ifdef PBUDGET_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return Simd_level::avx2;
+        if (__builtin_cpu_supports("sse2"))
+            return Simd_level::sse2;
+#endif
+        return Simd_level::scalar;
+    }
+
+    template <typename T>
+    Amount_split split_at_level(Simd_level level, const T* amounts, size_t count)
+    {
+        level = std::min(level, detected_simd_level());
+#ifdef PBUDGET_X86_KERNELS
+        if (level == Simd_level::avx2)
+            return split_avx2(amounts, count);
+        if (level == Simd_level::sse2)
+            return split_sse2(amounts, count);
+#endif
+        return split_scalar(amounts, count);
+    }
+}
+
+Simd_level detected_simd_level()
+{
+    static const Simd_level level = detect_simd_level();
+    return level;
+}
+
+const char* simd_level_to_string(Simd_level level)
+{
+    switch (level)
+    {
+        case Simd_level::avx2: return "avx2";
+        case Simd_level::sse2: return "sse2";
+        case Simd_level::scalar: return "scalar";
+    }
+    return "scalar";
+}
+
+Amount_split split_amounts(const std::int32_t* amounts, size_t count)
+{
+    return split_at_level(detected_simd_level(), amounts, count);
+}
+
+Amount_split split_amounts(const std::int64_t* amounts, size_t count)
+{
+    return split_at_level(detected_simd_level(), amounts, count);
+}
+
+Amount_split split_amounts(Simd_level level, const std::int32_t* amounts, size_t count)
+{
+    return split_at_level(level, amounts, count);
+}
+
+Amount_split split_amounts(Simd_level level, const std::int64_t* amounts, size_t count)
+{
+    return split_at_level(level, amounts, count);
+}
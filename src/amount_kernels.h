@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Money in/out over a contiguous array of amounts (cents): positives add to money_in, everything
+// else to money_out as a positive total. The kernels are branch-free and keep 64-bit totals, so a
+// ledger of any realistic size cannot overflow them.
+struct Amount_split
+{
+    std::int64_t money_in = 0;
+    std::int64_t money_out = 0;
+
+    bool operator==(const Amount_split& other) const = default;
+};
+
+enum class Simd_level { scalar, sse2, avx2 };
+
+// best level this CPU supports (checked once); split_amounts uses it
+Simd_level detected_simd_level();
+const char* simd_level_to_string(Simd_level level);
+
+Amount_split split_amounts(const std::int32_t* amounts, size_t count);
+Amount_split split_amounts(const std::int64_t* amounts, size_t count);
+
+// run one specific path; a level above what the CPU (or build) supports falls back to the best
+// one that is available. Tests and benchmarks use these to compare the paths.
+Amount_split split_amounts(Simd_level level, const std::int32_t* amounts, size_t count);
+Amount_split split_amounts(Simd_level level, const std::int64_t* amounts, size_t count);
@@ -1,16 +1,19 @@
 #include "app_controller.h"
 #include "future_app_state.h"
 #include "storage.h"
+#include <cstdlib>
+#include <utility>
 #include <vector>
 
 
-Controller::Controller(App_state& state, Storage& myDB) : state(state), db(myDB) {}
+Controller::Controller(App_state& state, Storage& myDB, Write_pipeline* pipeline) : state(state), db(myDB), pipeline(pipeline) {}
 
 
 void Controller::create_account(Account& account)
 {
-    db.save_account_info(account);
-    reload_wallet();
+    flush_writes();
+    if (std::optional<Storage_changes> changes = db.save_account_info(account))
+        apply_to_wallet(*changes);
     state.new_account_open = false;
 }
 
@@ -18,52 +21,213 @@ void Controller::modify_account(int account_id, const std::string& name, Account
                             int money_cents, int ir, int cp, int pr, int tm, int mp,
                             int rb, int rt, int ri, int rp, int rtot, int cl, int minp)
 {
-    db.modify_account_in_storage(account_id, name, type, money_cents, ir, cp, pr, tm, mp, rb, rt, ri, rp, rtot, cl, minp);
     state.modify_account_index = -1;
-    reload_wallet();
+    if (pipeline)
+    {
+        pipeline->submit([=, this](Storage& writer_db) -> Write_pipeline::Completion {
+            std::optional<Storage_changes> changes = writer_db.modify_account_in_storage(account_id, name, type, money_cents,
+                ir, cp, pr, tm, mp, rb, rt, ri, rp, rtot, cl, minp);
+            if (!changes)
+                return nullptr;
+            return [this, changes = std::move(*changes)]() {
+                db.apply_changes(changes);
+                apply_to_wallet(changes);
+            };
+        });
+        return;
+    }
+    std::optional<Storage_changes> changes = db.modify_account_in_storage(account_id, name, type, money_cents,
+        ir, cp, pr, tm, mp, rb, rt, ri, rp, rtot, cl, minp);
+    if (changes)
+        apply_to_wallet(*changes);
 }
 
 void Controller::delete_account(int account_id)
 {
-    db.delete_account(account_id);
+    flush_writes();
+    std::optional<Storage_changes> changes = db.delete_account(account_id);
     state.selected_account_index = -1;
     state.modify_account_index = -1;
-    db.load_all_transactions();
-    reload_wallet();
+    if (changes)
+        apply_to_wallet(*changes);
 }
 
 void Controller::create_transaction(int account_id, Transaction_info& trans)
 {
-    db.save_transaction_info(account_id, trans);
     state.create_transaction_open = false;
-    reload_wallet();
+    if (pipeline)
+    {
+        // show the balance the form computed right away. It is display only: the writer adds the
+        // amount to the stored balance, and the completion brings the committed figure.
+        patch_wallet_balance(account_id, trans.account_new_amount);
+        pipeline->submit([this, account_id, trans = std::move(trans)](Storage& writer_db) mutable -> Write_pipeline::Completion {
+            std::optional<Storage_changes> changes = writer_db.save_transaction_info(account_id, std::move(trans));
+            if (!changes)
+                return [this]() { reload_wallet(); };   // undo the optimistic balance
+            return [this, changes = std::move(*changes)]() {
+                db.apply_changes(changes);
+                apply_to_wallet(changes);
+            };
+        });
+        return;
+    }
+    if (std::optional<Storage_changes> changes = db.save_transaction_info(account_id, std::move(trans)))
+    {
+        apply_to_wallet(*changes);
+        trans = std::move(changes->inserted.front());   // hand the committed row, id filled in, back
+    }
+}
+
+// runs synchronously even with a pipeline: the caller gets the ids and balances filled in
+void Controller::create_transactions_batch(int account_id, std::span<Transaction_info> transactions)
+{
+    flush_writes();
+    if (std::optional<Storage_changes> changes = db.save_transactions_batch(account_id, transactions))
+        apply_to_wallet(*changes);
 }
 
 void Controller::delete_transaction(int transaction_id, int account_id)
 {
-    db.delete_transaction(transaction_id, account_id);
-    reload_wallet();
+    if (pipeline)
+    {
+        pipeline->submit([this, transaction_id, account_id](Storage& writer_db) -> Write_pipeline::Completion {
+            std::optional<Storage_changes> changes = writer_db.delete_transaction(transaction_id, account_id);
+            if (!changes)
+                return nullptr;
+            return [this, changes = std::move(*changes)]() {
+                db.apply_changes(changes);
+                apply_to_wallet(changes);
+            };
+        });
+        return;
+    }
+    if (std::optional<Storage_changes> changes = db.delete_transaction(transaction_id, account_id))
+        apply_to_wallet(*changes);
 }
 
-const std::vector<Transaction_info>& Controller::get_transactions(int account_id)
+const Account_transactions& Controller::get_transactions(int account_id)
 {
     return db.get_transactions(account_id);
 }
 
+std::span<const Transaction_text> Controller::get_transaction_text(int account_id)
+{
+    return display_cache.text(account_id, db.get_transactions(account_id));
+}
+
+std::span<const std::uint32_t> Controller::query_transactions(int account_id, const Transaction_query& query)
+{
+    return table_indexes[account_id].rows_for(db.get_transactions(account_id), query);
+}
+
+bool Controller::refresh_display_settings()
+{
+    if (!display_cache.refresh_settings())
+        return false;
+    state.frame_pacing.request_redraw();
+    return true;
+}
+
+Account_transactions::Date_range Controller::get_transactions_in_range(int account_id, std::time_t start, std::time_t end)
+{
+    return db.get_transactions_in_range(account_id, start, end);
+}
+
+std::string_view Controller::get_transaction_note(int account_id, int transaction_id)
+{
+    return db.get_transaction_note(account_id, transaction_id);
+}
+
 specific_range_of_transactions_info Controller::get_monthly_summary(int account_id, std::time_t start, std::time_t end)
 {
-    std::vector<Transaction_info> monthly = db.get_monthly_information(account_id, start, end);
-    return db.get_specific_range_of_transactions_info(monthly);
+    return db.get_range_summary(account_id, start, end);
+}
+
+std::int64_t Controller::get_balance_at(int account_id, std::time_t when)
+{
+    return db.get_balance_at(account_id, when).value_or(0);
+}
+
+std::int64_t Controller::get_net_worth_at(std::time_t when)
+{
+    return get_net_worth_series(std::span<const std::time_t>(&when, 1))[0];
+}
+
+std::vector<std::int64_t> Controller::get_net_worth_series(std::span<const std::time_t> times)
+{
+    std::vector<std::int64_t> net_worth(times.size(), 0);
+    std::shared_ptr<const Wallet_snapshot> wallet = state.wallet.snapshot();
+    for (const Account_info& acc : *wallet)
+    {
+        std::vector<std::int64_t> balances = db.get_balances_at(acc.account_id, times);
+        for (size_t i = 0; i < times.size(); ++i)
+            net_worth[i] += acc.is_asset ? balances[i] : -balances[i];
+    }
+    return net_worth;
+}
+
+void Controller::patch_wallet_balance(int account_id, int new_balance)
+{
+    state.wallet.patch(account_id, [new_balance](Account_info& acc) { acc.money_amount = new_balance; });
+    state.frame_pacing.request_redraw();
+}
+
+//patch the wallet in place from what a write committed; only a failed optimistic write falls
+//back to reload_wallet
+void Controller::apply_to_wallet(const Storage_changes& changes)
+{
+    for (const Account_info& saved : changes.accounts_saved)
+        state.wallet.put(saved);
+    for (const Storage_changes::Balance& balance : changes.balances)
+        patch_wallet_balance(balance.account_id, balance.money_amount);
+    for (int account_id : changes.accounts_deleted)
+        state.wallet.remove(account_id);
+    state.frame_pacing.request_redraw();   // inserted/removed rows change the tables even with no balance
 }
 
 void Controller::reload_wallet()
 {
-    state.wallet = this->db.load_accounts();
+    state.wallet.publish(db.load_accounts());
+    state.frame_pacing.request_redraw();
 }
 
 void Controller::create_internal_transfer(int account_id_from, int account_id_to, Transaction_info& trans)
 {
-    db.save_internal_transfer(account_id_from, account_id_to, trans);
-    reload_wallet();
+    if (pipeline)
+    {
+        // optimistic balances use the same rule the storage layer applies when it commits
+        int transfer_amount = std::abs(trans.transaction_amount);
+        state.wallet.patch(account_id_from, [transfer_amount](Account_info& acc) {
+            acc.money_amount = balance_after_transaction(acc.money_amount, transfer_amount, false, acc.is_asset);
+        });
+        state.wallet.patch(account_id_to, [transfer_amount](Account_info& acc) {
+            acc.money_amount = balance_after_transaction(acc.money_amount, transfer_amount, true, acc.is_asset);
+        });
+        state.frame_pacing.request_redraw();
+        pipeline->submit([this, account_id_from, account_id_to, trans = std::move(trans)](Storage& writer_db) mutable -> Write_pipeline::Completion {
+            std::optional<Storage_changes> changes = writer_db.save_internal_transfer(account_id_from, account_id_to, std::move(trans));
+            if (!changes)
+                return [this]() { reload_wallet(); };   // undo the optimistic balances
+            return [this, changes = std::move(*changes)]() {
+                db.apply_changes(changes);
+                apply_to_wallet(changes);
+            };
+        });
+        return;
+    }
+    if (std::optional<Storage_changes> changes = db.save_internal_transfer(account_id_from, account_id_to, std::move(trans)))
+        apply_to_wallet(*changes);
+}
+
+void Controller::process_completions()
+{
+    if (pipeline)
+        pipeline->process_completions();
+}
+
+void Controller::flush_writes()
+{
+    if (pipeline)
+        pipeline->flush();
 }
 
@@ -1,11 +1,17 @@
 #pragma once
 #include "future_app_state.h"
 #include "storage.h"
+#include "transaction_display.h"
+#include "transaction_table_index.h"
+#include "write_pipeline.h"
+#include <unordered_map>
 
 class Controller
 {
     public:
-        Controller(App_state& state, Storage& myDB);
+        // with a pipeline, transaction writes and account edits are committed on its writer thread
+        // and applied here in process_completions(); without one every write is synchronous
+        Controller(App_state& state, Storage& myDB, Write_pipeline* pipeline = nullptr);
 
         // write actions
         void create_account(Account& account);
@@ -13,20 +19,49 @@ class Controller
                             int money_cents, int ir, int cp, int pr, int tm, int mp,
                             int rb, int rt, int ri, int rp, int rtot, int cl, int minp);
         void delete_account(int account_id);
+        // trans is moved into the write, never copied: synchronously it comes back as the committed
+        // row (id filled in); with a pipeline it is left empty. A transfer always consumes it.
         void create_transaction(int account_id, Transaction_info& trans);
         void create_internal_transfer(int account_id_from, int account_id_to, Transaction_info& trans);
+        void create_transactions_batch(int account_id, std::span<Transaction_info> transactions);
         void delete_transaction(int transaction_id, int account_id);
   
         void reload_wallet();
 
+        // call once per frame on the UI thread; applies writes the pipeline has committed
+        void process_completions();
+        // block until every queued write has committed and been applied
+        void flush_writes();
+
         // read queries
-        const std::vector<Transaction_info>& get_transactions(int account_id);
+        const Account_transactions& get_transactions(int account_id);
+        Account_transactions::Date_range get_transactions_in_range(int account_id, std::time_t start, std::time_t end);
+        std::string_view get_transaction_note(int account_id, int transaction_id);
+        // formatted amount/date/type of every row of get_transactions(account_id), index-aligned;
+        // each row is formatted once, so tables can draw these every frame
+        std::span<const Transaction_text> get_transaction_text(int account_id);
+        // indices into get_transactions(account_id) of the rows matching the query, in its order
+        std::span<const std::uint32_t> query_transactions(int account_id, const Transaction_query& query);
+        // call when the app may have been idle for a while; a locale or timezone change reformats
+        // every row on next use. Returns true if the settings changed.
+        bool refresh_display_settings();
         specific_range_of_transactions_info get_monthly_summary(int account_id,
                                                                 std::time_t start,
                                                                 std::time_t end);
+        // point-in-time balances (see Storage::get_balance_at); net worth is assets minus
+        // liabilities over every account in the wallet
+        std::int64_t get_balance_at(int account_id, std::time_t when);
+        std::int64_t get_net_worth_at(std::time_t when);
+        std::vector<std::int64_t> get_net_worth_series(std::span<const std::time_t> times);
 
     private:
+        void apply_to_wallet(const Storage_changes& changes);
+        void patch_wallet_balance(int account_id, int new_balance);
+
         App_state& state;
         Storage& db;
+        Write_pipeline* pipeline;
+        Transaction_display_cache display_cache;
+        std::unordered_map<int, Transaction_table_index> table_indexes;
 };
 
@@ -71,6 +71,7 @@ class Transaction_info
         std::time_t ymd;                 // when the transaction occurred (Unix timestamp)
         std::string transaction_name;    // short label/name shown in UI
         std::string note;                // optional longer description
+        bool note_loaded = true;         // false when the row was read without its note (see Storage::get_transaction_note)
 };
 
 struct Liability_parameters
@@ -0,0 +1,140 @@
+#include "frame_profiler.h"
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    double ms_between(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+    {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+}
+
+Frame_profiler::Frame_profiler(size_t history_frames) : history(history_frames > 0 ? history_frames : 1) {}
+
+void Frame_profiler::begin_frame()
+{
+    current.frame_number = ++frame_number;
+    current.frame_ms = 0.0;
+    current.section_count = 0;
+    current.statement_count = 0;
+    current.sql_ms = 0.0;
+    current.allocations = 0;
+    open_count = 0;
+    skipped_open = 0;
+    in_frame = true;
+    allocations_at_start = allocation_counter ? allocation_counter() : 0;
+    frame_started = Clock::now();
+}
+
+void Frame_profiler::end_frame()
+{
+    if (!in_frame)
+        return;
+    const Clock::time_point now = Clock::now();
+    while (open_count > 0)   // a section left open (an early return) ends with the frame
+        end_section();
+    current.frame_ms = ms_between(frame_started, now);
+    current.allocations = allocation_counter ? allocation_counter() - allocations_at_start : 0;
+    in_frame = false;
+
+    history[next] = current;
+    next = (next + 1) % history.size();
+    if (count < history.size())
+        count++;
+}
+
+void Frame_profiler::begin_section(const char* name)
+{
+    if (!in_frame)
+        return;
+    if (skipped_open > 0 || open_count == Frame_profile::max_sections)   // nested in a skipped one, or too deep
+    {
+        skipped_open++;
+        return;
+    }
+    const int depth = static_cast<int>(open_count);
+    size_t index = current.section_count;
+    for (size_t i = 0; i < current.section_count; ++i)
+    {
+        if (current.sections[i].name == name && current.sections[i].depth == depth)
+        {
+            index = i;
+            break;
+        }
+    }
+    if (index == current.section_count)
+    {
+        if (current.section_count == Frame_profile::max_sections)
+        {
+            skipped_open++;
+            return;
+        }
+        current.sections[current.section_count++] = {name, depth, 0.0, 0};
+    }
+    current.sections[index].calls++;
+    open[open_count++] = {index, Clock::now()};
+}
+
+void Frame_profiler::end_section()
+{
+    if (skipped_open > 0)   // its begin_section found no room
+    {
+        skipped_open--;
+        return;
+    }
+    if (open_count == 0)
+        return;
+    const Open_section& section = open[--open_count];
+    current.sections[section.index].ms += ms_between(section.started, Clock::now());
+}
+
+void Frame_profiler::record_statement(const char* sql, double milliseconds)
+{
+    if (!in_frame)
+        return;
+    if (static_cast<size_t>(current.statement_count) < Frame_profile::max_statements)
+    {
+        Frame_profile::Statement& statement = current.statements[current.statement_count];
+        std::snprintf(statement.sql, sizeof(statement.sql), "%s", sql);
+        statement.ms = milliseconds;
+    }
+    current.statement_count++;
+    current.sql_ms += milliseconds;
+}
+
+void Frame_profiler::observe_statement(void* profiler, const char* sql, double milliseconds)
+{
+    static_cast<Frame_profiler*>(profiler)->record_statement(sql, milliseconds);
+}
+
+const Frame_profile& Frame_profiler::frame(size_t index) const
+{
+    const size_t oldest = count < history.size() ? 0 : next;
+    return history[(oldest + index) % history.size()];
+}
+
+bool Frame_profiler::dump(const std::string& path) const
+{
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Frame_profile& f = frame(i);
+        std::fprintf(file, "frame %lld: %.3f ms, %d SQL statements (%.3f ms), %lld allocations\n",
+            f.frame_number, f.frame_ms, f.statement_count, f.sql_ms, f.allocations);
+        for (size_t s = 0; s < f.section_count; ++s)
+        {
+            const Frame_profile::Section& section = f.sections[s];
+            std::fprintf(file, "  %*s%-28s %8.3f ms  x%d\n", section.depth * 2, "", section.name, section.ms, section.calls);
+        }
+        const int listed = f.statement_count < static_cast<int>(Frame_profile::max_statements)
+            ? f.statement_count : static_cast<int>(Frame_profile::max_statements);
+        for (int q = 0; q < listed; ++q)
+            std::fprintf(file, "  sql %8.3f ms  %s\n", f.statements[q].ms, f.statements[q].sql);
+        if (f.statement_count > listed)
+            std::fprintf(file, "  sql ... %d more\n", f.statement_count - listed);
+    }
+    return std::fclose(file) == 0;
+}
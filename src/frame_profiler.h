@@ -0,0 +1,116 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// What one frame spent: CPU time per named section (nested sections keep their depth), the SQL
+// statements the UI thread ran, and that thread's heap allocations. Fixed-size so recording a frame never
+// allocates and shows up in its own numbers.
+struct Frame_profile
+{
+    static constexpr size_t max_sections = 24;
+    static constexpr size_t max_statements = 16;   // only the first ones keep their text; all are counted
+
+    struct Section
+    {
+        const char* name;   // string literal
+        int depth;
+        double ms;
+        int calls;
+    };
+
+    struct Statement
+    {
+        char sql[96];   // truncated
+        double ms;
+    };
+
+    long long frame_number = 0;
+    double frame_ms = 0.0;
+    Section sections[max_sections];
+    size_t section_count = 0;
+    int statement_count = 0;
+    double sql_ms = 0.0;
+    Statement statements[max_statements];
+    long long allocations = 0;
+};
+
+// Collects a Frame_profile per frame into a rolling history for the profiler overlay. The main loop
+// brackets each frame with begin_frame()/end_frame(); panels time themselves with Profile_scope.
+// UI thread only; sections and statements recorded outside a frame are ignored.
+class Frame_profiler
+{
+    public:
+        using Allocation_counter = long long (*)();
+
+        explicit Frame_profiler(size_t history_frames = 240);
+
+        // heap allocations so far on the calling thread (the app replaces operator new to count
+        // them); without one, frames report 0 allocations
+        void set_allocation_counter(Allocation_counter counter) { allocation_counter = counter; }
+
+        void begin_frame();
+        void end_frame();
+
+        // a section opened twice at the same depth in one frame adds up into one entry
+        void begin_section(const char* name);
+        void end_section();
+
+        void record_statement(const char* sql, double milliseconds);
+        // matches Storage::Statement_observer, with the profiler as the context
+        static void observe_statement(void* profiler, const char* sql, double milliseconds);
+
+        // completed frames, oldest first; frame(history_size() - 1) is the last one
+        size_t history_size() const { return count; }
+        const Frame_profile& frame(size_t index) const;
+        long long frames_recorded() const { return frame_number; }
+
+        // the history as text, one block per frame; false if the file could not be written
+        bool dump(const std::string& path) const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        std::vector<Frame_profile> history;   // ring buffer
+        size_t next = 0;
+        size_t count = 0;
+
+        bool in_frame = false;
+        long long frame_number = 0;
+        Frame_profile current;
+        Clock::time_point frame_started;
+        long long allocations_at_start = 0;
+        Allocation_counter allocation_counter = nullptr;
+
+        // open sections: index into current.sections and start time
+        struct Open_section
+        {
+            size_t index;
+            Clock::time_point started;
+        };
+        Open_section open[Frame_profile::max_sections];
+        size_t open_count = 0;
+        size_t skipped_open = 0;   // sections begun without room to record them
+};
+
+// times the enclosing block as a section of the current frame; a null profiler records nothing
+class Profile_scope
+{
+    public:
+        Profile_scope(Frame_profiler* profiler, const char* name) : profiler(profiler)
+        {
+            if (profiler)
+                profiler->begin_section(name);
+        }
+        ~Profile_scope()
+        {
+            if (profiler)
+                profiler->end_section();
+        }
+        Profile_scope(const Profile_scope&) = delete;
+        Profile_scope& operator=(const Profile_scope&) = delete;
+
+    private:
+        Frame_profiler* profiler;
+};
@@ -1,6 +1,24 @@
 #pragma once
+#include <algorithm>
 #include <vector>
+#include "frame_profiler.h"
 #include "storage.h"
+#include "wallet.h"
+
+// The main loop renders only while something can change what is on screen; otherwise it sleeps in
+// glfwWaitEventsTimeout. Input, Controller writes and anything animating call request_redraw().
+struct Frame_pacing
+{
+    // ImGui settles hover/active state and layout over a few frames after a change
+    static constexpr int settle_frames = 3;
+
+    int redraw_frames = 0;           // frames still to render at full rate
+    long long frames_rendered = 0;
+    long long frames_skipped = 0;    // refresh intervals spent asleep instead of rendering
+
+    void request_redraw() { redraw_frames = std::max(redraw_frames, settle_frames); }
+    bool dirty() const { return redraw_frames > 0; }
+};
 
 struct App_state
 {
@@ -10,5 +28,8 @@ struct App_state
     int modify_account_index = -1;
     bool create_transaction_open = false;
     float dpi_scale = 1.0f;
-    std::vector<Account_info> wallet;
-};
\ No newline at end of file
+    Wallet wallet;
+    Frame_pacing frame_pacing;
+    Frame_profiler profiler;
+    bool profiler_open = false;
+};
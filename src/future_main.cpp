@@ -5,16 +5,48 @@
 
 #include "UI/sidebar_panel.h"
 #include "UI/right_panel.h"
+#include "UI/profiler_overlay.h"
 #include "future_app_state.h"
 
 
 
+#include "allocation_counter.h"
 #include "storage.h"
+#include "write_pipeline.h"
 #include <GLFW/glfw3.h>
+#include <atomic>
 #include <cstdio>
 #include <ctime>
 
 
+namespace
+{
+    // set by the GLFW callbacks below (ImGui's backend chains to them), read by the main loop
+    std::atomic<bool> input_arrived{false};
+
+    void note_input() { input_arrived.store(true, std::memory_order_relaxed); }
+
+    //registered before ImGui_ImplGlfw_InitForOpenGL so the backend's own callbacks call these too
+    void install_input_callbacks(GLFWwindow* window)
+    {
+        glfwSetCursorPosCallback(window, [](GLFWwindow*, double, double) { note_input(); });
+        glfwSetMouseButtonCallback(window, [](GLFWwindow*, int, int, int) { note_input(); });
+        glfwSetScrollCallback(window, [](GLFWwindow*, double, double) { note_input(); });
+        glfwSetKeyCallback(window, [](GLFWwindow*, int, int, int, int) { note_input(); });
+        glfwSetCharCallback(window, [](GLFWwindow*, unsigned int) { note_input(); });
+        glfwSetWindowFocusCallback(window, [](GLFWwindow*, int) { note_input(); });
+        glfwSetCursorEnterCallback(window, [](GLFWwindow*, int) { note_input(); });
+        // not chained by the backend: resizes and exposes just need a fresh frame
+        glfwSetFramebufferSizeCallback(window, [](GLFWwindow*, int, int) { note_input(); });
+        glfwSetWindowRefreshCallback(window, [](GLFWwindow*) { note_input(); });
+    }
+
+    //widgets that change on their own while held or focused: drags, held buttons, the text caret
+    bool imgui_wants_full_rate(const ImGuiIO& io)
+    {
+        return io.WantTextInput || ImGui::IsAnyItemActive() || ImGui::IsAnyMouseDown();
+    }
+}
 
 
 int main() {
@@ -23,6 +55,8 @@ int main() {
     GLFWwindow* window = glfwCreateWindow(1200, 800, "MyBudget", NULL, NULL);
     if (!window) return 1;
     glfwMakeContextCurrent(window);
+    glfwSwapInterval(1);   // full rate means the display's rate, not a busy loop
+    install_input_callbacks(window);
 
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -87,21 +121,54 @@ int main() {
     bool open = true;
         
     //CREATE OUR DATABASE
-    auto myDB = Storage();
+    Storage myDB("mydata.db", Storage_options::fast_interactive());
+    Write_pipeline write_pipeline("mydata.db", Storage_options::fast_interactive());
 
 
     App_state state;
     state.dpi_scale = dpi_scale;
-    Controller controller(state, myDB);
-    state.wallet = myDB.load_accounts();
+    Controller controller(state, myDB, &write_pipeline);
+    state.wallet.publish(myDB.load_accounts());
     myDB.load_all_transactions();
+    state.profiler.set_allocation_counter(&allocation_count);
+    myDB.set_statement_observer(&Frame_profiler::observe_statement, &state.profiler);
+    // a write committing while the loop sleeps wakes it to apply the completion
+    write_pipeline.set_completion_notifier([]() { glfwPostEmptyEvent(); });
+
+    // idle: with no input, no pending redraw and nothing active, sleep until an event arrives.
+    // The timeout is a heartbeat that keeps date-based text current.
+    const double idle_heartbeat_seconds = 1.0;
+    const GLFWvidmode* video_mode = primary ? glfwGetVideoMode(primary) : nullptr;
+    const double refresh_hz = (video_mode && video_mode->refreshRate > 0) ? video_mode->refreshRate : 60.0;
+    Frame_pacing& pacing = state.frame_pacing;
+    pacing.request_redraw();
 
 
 
 
     while (!glfwWindowShouldClose(window)) 
     {
-        glfwPollEvents();
+        if (pacing.dirty() || imgui_wants_full_rate(io))
+            glfwPollEvents();
+        else
+        {
+            const double slept_from = glfwGetTime();
+            glfwWaitEventsTimeout(idle_heartbeat_seconds);
+            pacing.frames_skipped += static_cast<long long>((glfwGetTime() - slept_from) * refresh_hz);
+            // the timezone or locale may have changed while idle; cached row text is redone if so
+            controller.refresh_display_settings();
+        }
+        if (input_arrived.exchange(false, std::memory_order_relaxed))
+            pacing.request_redraw();
+        state.profiler.begin_frame();
+        {
+            Profile_scope scope(&state.profiler, "process_completions");
+            controller.process_completions();
+        }
+        if (pacing.redraw_frames > 0)
+            pacing.redraw_frames--;
+        pacing.frames_rendered++;
+
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
@@ -120,23 +187,46 @@ int main() {
         const float left_pane_width = win_w * left_ratio - ImGui::GetStyle().ItemSpacing.x * 0.5f;
         const float right_pane_width = win_w * (1.f - left_ratio) - ImGui::GetStyle().ItemSpacing.x * 0.5f;
 
-        Sidebar_result sidebar_result = draw_sidebar(state, controller, left_pane_width);
+        Sidebar_result sidebar_result;
+        {
+            Profile_scope scope(&state.profiler, "draw_sidebar");
+            sidebar_result = draw_sidebar(state, controller, left_pane_width);
+        }
         if (sidebar_result.exit_requested)
         {
             glfwSetWindowShouldClose(window, true);
         }
 
         ImGui::SameLine();
-        draw_right_panel(state, controller, right_pane_width, font_large);
+        {
+            Profile_scope scope(&state.profiler, "draw_right_panel");
+            draw_right_panel(state, controller, right_pane_width, font_large);
+        }
         ImGui::End();
 
-        ImGui::Render();
-        glClear(GL_COLOR_BUFFER_BIT);
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        if (ImGui::IsKeyPressed(ImGuiKey_F1, false))
+            state.profiler_open = !state.profiler_open;
+        {
+            Profile_scope scope(&state.profiler, "draw_profiler_overlay");
+            draw_profiler_overlay(state);
+        }
+
+        {
+            Profile_scope scope(&state.profiler, "render");
+            ImGui::Render();
+            glClear(GL_COLOR_BUFFER_BIT);
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
+        state.profiler.end_frame();   // before the swap, which waits for vsync
         glfwSwapBuffers(window);
         
     }
 
+    // commit the queued writes while GLFW is still up: the notifier posts GLFW events from the
+    // writer thread, so it goes first, and flush() runs the last completions against App_state
+    write_pipeline.set_completion_notifier(nullptr);
+    write_pipeline.flush();
+
     // Cleanup
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
@@ -1,4 +1,5 @@
 #include "helpers.h"
+#include <utility>
 
 // Transaction UI helpers
 
@@ -51,8 +52,8 @@ Transaction_info create_transaction_info(int account_id, int transaction_amount,
     trans_info.type_of_transaction = type_of_transaction;
     trans_info.transaction_category_need = transaction_category_need;
     trans_info.transaction_category_want = transaction_category_want;
-    trans_info.transaction_name = transaction_name;
-    trans_info.note = note;
+    trans_info.transaction_name = std::move(transaction_name);
+    trans_info.note = std::move(note);
     trans_info.account_previous_amount = account_previous_amount;
     trans_info.account_new_amount = account_new_amount;
     trans_info.ymd = std::time(nullptr);
@@ -162,7 +163,7 @@ int compounding_index_from_frequency(int frequency)
     return 2;
 }
 
-float cents_to_dollars(int cents)
+float cents_to_dollars(std::int64_t cents)
 {
     return static_cast<float>(cents) / 100.0f;
 }
@@ -224,3 +225,19 @@ const char* account_type_to_string(Account_type account_type)
     }
 }
 
+int year_month_from_time(std::time_t t)
+{
+    std::tm local_tm = {};
+    localtime_r(&t, &local_tm);
+    return (local_tm.tm_year + 1900) * 100 + (local_tm.tm_mon + 1);
+}
+
+std::time_t time_from_year_month(int year_month)
+{
+    std::tm local_tm = {};
+    local_tm.tm_year = year_month / 100 - 1900;
+    local_tm.tm_mon = year_month % 100 - 1;   // mktime carries month 12 + 1 into the next year
+    local_tm.tm_mday = 1;
+    local_tm.tm_isdst = -1;
+    return std::mktime(&local_tm);
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <ctime>
 #include "core_logic.h"
@@ -13,7 +14,7 @@ bool account_type_is_asset(Account_type t);
 int compounding_frequency_from_index(int combo_index);
 int compounding_index_from_frequency(int frequency);
 
-float cents_to_dollars(int cents);
+float cents_to_dollars(std::int64_t cents);
 
 Transaction_type deposit_transaction_type_from_dropdown(int current_item_deposit);
 Transaction_type withdrawal_transaction_type_from_dropdown(int current_item_withdrawal);
@@ -37,6 +38,8 @@ Transaction_category_want transaction_category_want_from_string(const char* cate
 //storage.cpp helpers
 
 const char* account_type_to_string(Account_type account_type);
+int year_month_from_time(std::time_t t);   // YYYYMM in local time, the monthly_rollups key
+std::time_t time_from_year_month(int year_month);   // local midnight on the 1st of YYYYMM
 const char* transaction_type_to_string(Transaction_type type_of_transaction);
 const char* transaction_category_need_to_string(Transaction_category_need transaction_category_need);
 const char* transaction_category_want_to_string(Transaction_category_want transaction_category_want);
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+// A vector that holds its first N elements in place and only moves to the heap once it grows past
+// that, for lists that are nearly always one or two long (what a single write changed). Elements
+// must be default-constructible: unused inline slots hold default values.
+template <typename T, size_t N>
+class Small_vector
+{
+    public:
+        Small_vector() = default;
+        Small_vector(std::initializer_list<T> items)
+        {
+            reserve(items.size());
+            for (const T& item : items)
+                push_back(item);
+        }
+
+        size_t size() const { return on_heap ? heap.size() : inline_count; }
+        bool empty() const { return size() == 0; }
+
+        T* begin() { return on_heap ? heap.data() : inline_items.data(); }
+        T* end() { return begin() + size(); }
+        const T* begin() const { return on_heap ? heap.data() : inline_items.data(); }
+        const T* end() const { return begin() + size(); }
+
+        T& operator[](size_t index) { return begin()[index]; }
+        const T& operator[](size_t index) const { return begin()[index]; }
+        T& front() { return *begin(); }
+        const T& front() const { return *begin(); }
+        T& back() { return end()[-1]; }
+        const T& back() const { return end()[-1]; }
+
+        void push_back(T item)
+        {
+            if (!on_heap && inline_count < N)
+            {
+                inline_items[inline_count++] = std::move(item);
+                return;
+            }
+            move_to_heap(2 * N);
+            heap.push_back(std::move(item));
+        }
+
+        template <typename Iterator>
+        void assign(Iterator first, Iterator last)
+        {
+            clear();
+            reserve(static_cast<size_t>(std::distance(first, last)));
+            for (; first != last; ++first)
+                push_back(*first);
+        }
+
+        void reserve(size_t count)
+        {
+            if (count <= N)
+                return;
+            move_to_heap(count);
+            heap.reserve(count);
+        }
+
+        void clear()
+        {
+            std::fill(inline_items.begin(), inline_items.begin() + inline_count, T{});
+            inline_count = 0;
+            heap.clear();
+            on_heap = false;
+        }
+
+        bool operator==(const Small_vector& other) const
+        {
+            return std::equal(begin(), end(), other.begin(), other.end());
+        }
+
+    private:
+        void move_to_heap(size_t capacity)
+        {
+            if (on_heap)
+                return;
+            heap.reserve(std::max(capacity, inline_count));
+            for (size_t i = 0; i < inline_count; ++i)
+                heap.push_back(std::exchange(inline_items[i], T{}));
+            inline_count = 0;
+            on_heap = true;
+        }
+
+        std::array<T, N> inline_items{};
+        size_t inline_count = 0;
+        bool on_heap = false;
+        std::vector<T> heap;
+};
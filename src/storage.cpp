@@ -1,18 +1,197 @@
 extern "C"{
     #include "../external/sqlite/sqlite3.h"
 }
+#include <algorithm>
 #include <iostream>
 #include <cstring>
+#include <iterator>
+#include <limits>
+#include "amount_kernels.h"
 #include "core_logic.h"
 #include "helpers.h"
 #include "storage.h"
 
+namespace
+{
+    bool exec_sql(sqlite3* db, const char* sql, const char* what)
+    {
+        char* err = nullptr;
+        int rc = sqlite3_exec(db, sql, nullptr, nullptr, &err);
+        if (rc != SQLITE_OK)
+        {
+            std::cerr << what << " failed: " << (err ? err : sqlite3_errmsg(db)) << std::endl;
+            sqlite3_free(err);
+            return false;
+        }
+        return true;
+    }
+
+    bool table_has_column(sqlite3* db, const char* table, const char* column)
+    {
+        std::string sql = std::string("PRAGMA table_info(") + table + ");";
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+            return false;
+        bool found = false;
+        while (!found && sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            const char* name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            found = name && std::strcmp(name, column) == 0;
+        }
+        sqlite3_finalize(stmt);
+        return found;
+    }
+
+    // v1: databases written by early builds predate the optional account columns and the
+    // transaction category; add whatever is missing so SELECT * column positions line up.
+    bool migrate_add_missing_columns(sqlite3* db)
+    {
+        struct Column { const char* table; const char* name; const char* declaration; };
+        const Column columns[] = {
+            {"accounts", "initial_money_amount", "INTEGER DEFAULT 0"},
+            {"accounts", "is_asset", "INTEGER DEFAULT 1"},
+            {"accounts", "interest_rate", "INTEGER DEFAULT 0"},
+            {"accounts", "compounding_frequency", "INTEGER DEFAULT 0"},
+            {"accounts", "principal", "INTEGER DEFAULT 0"},
+            {"accounts", "term", "INTEGER DEFAULT 0"},
+            {"accounts", "monthly_payment", "INTEGER DEFAULT 0"},
+            {"accounts", "remaining_balance", "INTEGER DEFAULT 0"},
+            {"accounts", "remaining_term", "INTEGER DEFAULT 0"},
+            {"accounts", "remaining_interest", "INTEGER DEFAULT 0"},
+            {"accounts", "remaining_principal", "INTEGER DEFAULT 0"},
+            {"accounts", "remaining_total", "INTEGER DEFAULT 0"},
+            {"accounts", "credit_limit", "INTEGER DEFAULT 0"},
+            {"accounts", "minimum_payment", "INTEGER DEFAULT 0"},
+            {"transactions_table", "transaction_category", "TEXT"},
+        };
+        for (const Column& column : columns)
+        {
+            if (table_has_column(db, column.table, column.name))
+                continue;
+            std::string sql = std::string("ALTER TABLE ") + column.table + " ADD COLUMN " + column.name + " " + column.declaration + ";";
+            if (!exec_sql(db, sql.c_str(), "migration ADD COLUMN"))
+                return false;
+        }
+        return true;
+    }
+
+    // v2: every per-account read filters on account_id and usually a date range, and the
+    // summaries only need the amount, so (account_id, transaction_date, transaction_amount)
+    // lets them run as covering index range scans instead of full table scans.
+    bool migrate_transaction_indexes(sqlite3* db)
+    {
+        return exec_sql(db,
+            "CREATE INDEX IF NOT EXISTS idx_transactions_account_date "
+            "ON transactions_table(account_id, transaction_date, transaction_amount);",
+            "migration CREATE INDEX");
+    }
+
+    // Rebuilds monthly_rollups from the raw rows. year_month is YYYYMM in local time, matching
+    // year_month_from_time() and the month boundaries the UI asks for.
+    const char* sql_rebuild_monthly_rollups =
+    R"(DELETE FROM monthly_rollups;
+    INSERT INTO monthly_rollups(account_id, year_month, money_in, money_out, txn_count)
+    SELECT account_id,
+           CAST(strftime('%Y%m', transaction_date, 'unixepoch', 'localtime') AS INTEGER),
+           SUM(CASE WHEN transaction_amount > 0 THEN transaction_amount ELSE 0 END),
+           SUM(CASE WHEN transaction_amount > 0 THEN 0 ELSE -transaction_amount END),
+           COUNT(*)
+    FROM transactions_table
+    GROUP BY 1, 2;)";
+
+    // v3: per-account, per-month totals kept in step with every write, so multi-year summaries
+    // read one row per month instead of every transaction.
+    bool migrate_monthly_rollups(sqlite3* db)
+    {
+        return exec_sql(db,
+            R"(CREATE TABLE IF NOT EXISTS monthly_rollups(
+                account_id INTEGER NOT NULL,
+                year_month INTEGER NOT NULL,
+                money_in INTEGER NOT NULL DEFAULT 0,
+                money_out INTEGER NOT NULL DEFAULT 0,
+                txn_count INTEGER NOT NULL DEFAULT 0,
+                PRIMARY KEY (account_id, year_month)
+            ) WITHOUT ROWID;)",
+            "migration CREATE monthly_rollups")
+            && exec_sql(db, sql_rebuild_monthly_rollups, "migration populate monthly_rollups");
+    }
+
+    void decode_category(Transaction_type type, const unsigned char* text,
+        Transaction_category_need& need, Transaction_category_want& want)
+    {
+        const char* cat_text = reinterpret_cast<const char*>(text);
+        if (!cat_text)
+            return;
+        if (type == Transaction_type::Need)
+            need = transaction_category_need_from_string(cat_text);
+        else if (type == Transaction_type::Want)
+            want = transaction_category_want_from_string(cat_text);
+    }
+
+    //SELECT * FROM accounts row; old databases may lack the later columns
+    Account_info account_info_from_stmt(sqlite3_stmt* stmt)
+    {
+        int columns = sqlite3_column_count(stmt);
+        auto column_or_zero = [stmt, columns](int column) { return columns > column ? sqlite3_column_int(stmt, column) : 0; };
+
+        Account_info acc_info;
+        acc_info.account_id = sqlite3_column_int(stmt, 0);
+        acc_info.money_amount = sqlite3_column_int(stmt, 1);
+        acc_info.account_name = std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)));
+        acc_info.account_type = std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)));
+        acc_info.initial_money_amount = column_or_zero(4);
+        acc_info.is_asset = column_or_zero(5);
+        acc_info.interest_rate = column_or_zero(6);
+        acc_info.compounding_frequency = column_or_zero(7);
+        acc_info.principal = column_or_zero(8);
+        acc_info.term = column_or_zero(9);
+        acc_info.monthly_payment = column_or_zero(10);
+        acc_info.remaining_balance = column_or_zero(11);
+        acc_info.remaining_term = column_or_zero(12);
+        acc_info.remaining_interest = column_or_zero(13);
+        acc_info.remaining_principal = column_or_zero(14);
+        acc_info.remaining_total = column_or_zero(15);
+        acc_info.credit_limit = column_or_zero(16);
+        acc_info.minimum_payment = column_or_zero(17);
+        return acc_info;
+    }
+
+    specific_range_of_transactions_info range_info_from_split(const Amount_split& split)
+    {
+        specific_range_of_transactions_info range_info;
+        range_info.money_in = split.money_in;
+        range_info.money_out = split.money_out;
+        range_info.money_remaining = std::max<std::int64_t>(split.money_in - split.money_out, 0);
+        return range_info;
+    }
+
+    int next_year_month(int year_month)
+    {
+        return year_month % 100 == 12 ? year_month + 89 : year_month + 1;   // 202412 -> 202501
+    }
+
+    struct Schema_migration
+    {
+        int version;
+        const char* description;
+        bool (*apply)(sqlite3* db);
+    };
+
+    // Append new steps at the end; never renumber or edit a step that has shipped.
+    const Schema_migration schema_migrations[] = {
+        {1, "add missing account/transaction columns", migrate_add_missing_columns},
+        {2, "index transactions by account and date", migrate_transaction_indexes},
+        {3, "monthly rollup table", migrate_monthly_rollups},
+    };
+}
+
 
 //create the storage object if it doesnt exist yet, and open the database
-Storage::Storage(const std::string& db_path)
+Storage::Storage(const std::string& db_path, const Storage_options& options)
     {
 
         int rc;
+        cache_writes = options.cache_writes;
 
         rc = sqlite3_open(db_path.c_str(), &db);
 
@@ -23,6 +202,7 @@ Storage::Storage(const std::string& db_path)
         else 
         {
             std::cout << "Opened database successfully" << std::endl;
+            apply_options(options);
         }
 
         const char* sql_accounts = 
@@ -84,11 +264,28 @@ Storage::Storage(const std::string& db_path)
         {
             std::cout << "Transactions table created successfully" << std::endl;
         }
+
+        run_migrations();
+        open_read_connections(db_path, options);
     }
 
 //close the database when the storage object is destroyed
 Storage::~Storage()
 {
+    for (auto& reader : read_connections)
+    {
+        for (auto& [sql, stmt] : reader->statements)
+            sqlite3_finalize(stmt);
+        sqlite3_close(reader->db);
+    }
+    read_connections.clear();
+    idle_readers.clear();
+
+    for (auto& [sql, prepared] : prepared_statements)
+    {
+        sqlite3_finalize(prepared.stmt);
+    }
+    prepared_statements.clear();
     if(db)
     {
         sqlite3_close(db);
@@ -96,8 +293,324 @@ Storage::~Storage()
     db = nullptr;
 }
 
+int Storage::schema_version()
+{
+    sqlite3_stmt* stmt = get_prepared_statement("PRAGMA user_version;");
+    int version = 0;
+    if (stmt)
+    {
+        if (sqlite3_step(stmt) == SQLITE_ROW)
+            version = sqlite3_column_int(stmt, 0);
+        sqlite3_reset(stmt);
+    }
+    return version;
+}
+
+int Storage::latest_schema_version()
+{
+    return schema_migrations[std::size(schema_migrations) - 1].version;
+}
+
+Storage_options Storage_options::max_durability()
+{
+    Storage_options options;
+    options.journal_mode = Journal_mode::rollback;
+    options.synchronous = Synchronous_mode::extra;
+    options.busy_timeout_ms = 5000;
+    return options;
+}
+
+Storage_options Storage_options::fast_interactive()
+{
+    Storage_options options;
+    options.journal_mode = Journal_mode::wal;
+    options.synchronous = Synchronous_mode::normal;
+    options.cache_size = -16384;                 // 16 MiB
+    options.mmap_size = 256LL * 1024 * 1024;
+    options.temp_store = Temp_store::memory;
+    options.busy_timeout_ms = 5000;
+    options.read_connections = 2;
+    return options;
+}
+
+//set the connection pragmas before any table is touched, then log what actually took effect.
+//journal_mode goes first: synchronous is interpreted differently under WAL.
+void Storage::apply_options(const Storage_options& options)
+{
+    if (options.journal_mode)
+    {
+        exec_sql(db, *options.journal_mode == Journal_mode::wal ? "PRAGMA journal_mode = WAL;" : "PRAGMA journal_mode = DELETE;",
+            "PRAGMA journal_mode");
+    }
+    if (options.synchronous)
+    {
+        std::string sql = "PRAGMA synchronous = " + std::to_string(static_cast<int>(*options.synchronous)) + ";";
+        exec_sql(db, sql.c_str(), "PRAGMA synchronous");
+    }
+    if (options.cache_size)
+    {
+        std::string sql = "PRAGMA cache_size = " + std::to_string(*options.cache_size) + ";";
+        exec_sql(db, sql.c_str(), "PRAGMA cache_size");
+    }
+    if (options.mmap_size)
+    {
+        std::string sql = "PRAGMA mmap_size = " + std::to_string(*options.mmap_size) + ";";
+        exec_sql(db, sql.c_str(), "PRAGMA mmap_size");
+    }
+    if (options.temp_store)
+    {
+        std::string sql = "PRAGMA temp_store = " + std::to_string(static_cast<int>(*options.temp_store)) + ";";
+        exec_sql(db, sql.c_str(), "PRAGMA temp_store");
+    }
+    if (options.busy_timeout_ms > 0)
+    {
+        sqlite3_busy_timeout(db, options.busy_timeout_ms);
+    }
+
+    Storage_settings settings = effective_settings();
+    std::cout << "Storage settings: journal_mode=" << settings.journal_mode
+              << " synchronous=" << settings.synchronous
+              << " cache_size=" << settings.cache_size
+              << " mmap_size=" << settings.mmap_size
+              << " temp_store=" << settings.temp_store
+              << " busy_timeout=" << settings.busy_timeout_ms << "ms" << std::endl;
+}
+
+//open the read-only pool. Readers only help under WAL, where they read the last committed
+//snapshot while a write is in progress; with a rollback journal they would just contend for
+//the same lock, so the pool stays empty and the thread-safe reads use the main connection.
+void Storage::open_read_connections(const std::string& db_path, const Storage_options& options)
+{
+    if (!db || options.read_connections <= 0)
+        return;
+    if (effective_settings().journal_mode != "wal")
+    {
+        std::cerr << "read connections need WAL; thread-safe reads will use the main connection" << std::endl;
+        return;
+    }
+
+    for (int i = 0; i < options.read_connections; ++i)
+    {
+        sqlite3* reader_db = nullptr;
+        int rc = sqlite3_open_v2(db_path.c_str(), &reader_db, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr);
+        if (rc != SQLITE_OK)
+        {
+            std::cerr << "Can't open read connection: " << sqlite3_errmsg(reader_db) << std::endl;
+            sqlite3_close(reader_db);
+            break;
+        }
+        if (options.cache_size)
+        {
+            std::string sql = "PRAGMA cache_size = " + std::to_string(*options.cache_size) + ";";
+            exec_sql(reader_db, sql.c_str(), "reader PRAGMA cache_size");
+        }
+        if (options.mmap_size)
+        {
+            std::string sql = "PRAGMA mmap_size = " + std::to_string(*options.mmap_size) + ";";
+            exec_sql(reader_db, sql.c_str(), "reader PRAGMA mmap_size");
+        }
+        if (options.temp_store)
+        {
+            std::string sql = "PRAGMA temp_store = " + std::to_string(static_cast<int>(*options.temp_store)) + ";";
+            exec_sql(reader_db, sql.c_str(), "reader PRAGMA temp_store");
+        }
+        if (options.busy_timeout_ms > 0)
+            sqlite3_busy_timeout(reader_db, options.busy_timeout_ms);
+
+        auto reader = std::make_unique<Read_connection>();
+        reader->db = reader_db;
+        idle_readers.push_back(reader.get());
+        read_connections.push_back(std::move(reader));
+    }
+    std::cout << "Opened " << read_connections.size() << " read-only connections" << std::endl;
+}
+
+Storage::Read_lease::Read_lease(Storage& storage) : storage(storage)
+{
+    if (storage.read_connections.empty())
+        return;
+    std::unique_lock<std::mutex> lock(storage.read_pool_mutex);
+    storage.reader_released.wait(lock, [&storage]() { return !storage.idle_readers.empty(); });
+    reader = storage.idle_readers.back();
+    storage.idle_readers.pop_back();
+}
+
+Storage::Read_lease::~Read_lease()
+{
+    if (!reader)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(storage.read_pool_mutex);
+        storage.idle_readers.push_back(reader);
+    }
+    storage.reader_released.notify_all();   // set_statement_observer waits for the whole pool, not one reader
+}
+
+sqlite3_stmt* Storage::Read_lease::prepare(const char* sql)
+{
+    if (!reader)
+        return storage.get_prepared_statement(sql);
+
+    auto it = reader->statements.find(sql);
+    if (it != reader->statements.end())
+    {
+        sqlite3_reset(it->second);
+        sqlite3_clear_bindings(it->second);
+        return it->second;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v3(reader->db, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) != SQLITE_OK)
+    {
+        sqlite3_finalize(stmt);
+        return nullptr;
+    }
+    reader->statements.emplace(sql, stmt);
+    return stmt;
+}
+
+sqlite3* Storage::Read_lease::connection() const
+{
+    return reader ? reader->db : storage.db;
+}
+
+Storage_settings Storage::effective_settings()
+{
+    Storage_settings settings;
+    if (!db)
+        return settings;
+
+    auto read_pragma = [this](const char* sql, auto read_column)
+    {
+        sqlite3_stmt* stmt = get_prepared_statement(sql);
+        if (stmt)
+        {
+            if (sqlite3_step(stmt) == SQLITE_ROW)
+                read_column(stmt);
+            sqlite3_reset(stmt);
+        }
+    };
+
+    read_pragma("PRAGMA journal_mode;", [&](sqlite3_stmt* stmt) {
+        const unsigned char* mode = sqlite3_column_text(stmt, 0);
+        settings.journal_mode = mode ? reinterpret_cast<const char*>(mode) : "";
+    });
+    read_pragma("PRAGMA synchronous;", [&](sqlite3_stmt* stmt) { settings.synchronous = sqlite3_column_int(stmt, 0); });
+    read_pragma("PRAGMA cache_size;", [&](sqlite3_stmt* stmt) { settings.cache_size = sqlite3_column_int(stmt, 0); });
+    read_pragma("PRAGMA mmap_size;", [&](sqlite3_stmt* stmt) { settings.mmap_size = sqlite3_column_int64(stmt, 0); });
+    read_pragma("PRAGMA temp_store;", [&](sqlite3_stmt* stmt) { settings.temp_store = sqlite3_column_int(stmt, 0); });
+    read_pragma("PRAGMA busy_timeout;", [&](sqlite3_stmt* stmt) { settings.busy_timeout_ms = sqlite3_column_int(stmt, 0); });
+    settings.read_connections = static_cast<int>(read_connections.size());
+    return settings;
+}
+
+//upgrade the schema in place, one PRAGMA user_version step at a time
+void Storage::run_migrations()
+{
+    if (!db)
+        return;
+
+    const int current_version = schema_version();
+    for (const Schema_migration& migration : schema_migrations)
+    {
+        if (migration.version <= current_version)
+            continue;
+
+        if (!exec_sql(db, "BEGIN IMMEDIATE;", "migration BEGIN"))
+            return;
+
+        std::string set_version = "PRAGMA user_version = " + std::to_string(migration.version) + ";";
+        if (!migration.apply(db) || !exec_sql(db, set_version.c_str(), "migration user_version"))
+        {
+            std::cerr << "schema migration " << migration.version << " (" << migration.description << ") failed" << std::endl;
+            exec_sql(db, "ROLLBACK;", "migration ROLLBACK");
+            return;
+        }
+
+        if (!exec_sql(db, "COMMIT;", "migration COMMIT"))
+        {
+            exec_sql(db, "ROLLBACK;", "migration ROLLBACK");
+            return;
+        }
+        std::cout << "Schema migrated to version " << migration.version << " (" << migration.description << ")" << std::endl;
+    }
+}
+
+//return a long-lived prepared statement for sql, preparing it on first use.
+//the statement comes back reset with its bindings cleared; callers sqlite3_reset it when done
+//and must never finalize it (the destructor owns that).
+sqlite3_stmt* Storage::get_prepared_statement(const char* sql)
+{
+    auto it = prepared_statements.find(sql);
+    if (it != prepared_statements.end() && it->second.stmt)
+    {
+        it->second.hit_count++;
+        sqlite3_reset(it->second.stmt);
+        sqlite3_clear_bindings(it->second.stmt);
+        return it->second.stmt;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v3(db, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr);
+    if (rc != SQLITE_OK)
+    {
+        sqlite3_finalize(stmt);
+        return nullptr;
+    }
+
+    Prepared_statement& prepared = prepared_statements[sql];
+    prepared.stmt = stmt;
+    prepared.prepare_count++;
+    return stmt;
+}
+
+std::vector<Statement_stats> Storage::get_statement_stats() const
+{
+    std::vector<Statement_stats> stats;
+    stats.reserve(prepared_statements.size());
+    for (const auto& [sql, prepared] : prepared_statements)
+    {
+        stats.push_back({std::string(sql), prepared.prepare_count, prepared.hit_count});
+    }
+    return stats;
+}
+
+//the pooled readers are traced too, but only statements stepped on the observer's thread are
+//reported. Holding the pool lock with every reader idle means no lease is using one while its
+//trace changes, and the next lease sees the new observer.
+void Storage::set_statement_observer(Statement_observer observer, void* context)
+{
+    std::unique_lock<std::mutex> lock(read_pool_mutex);
+    reader_released.wait(lock, [this]() { return idle_readers.size() == read_connections.size(); });
+
+    statement_observer = observer;
+    statement_observer_context = context;
+    statement_observer_thread = std::this_thread::get_id();
+    auto trace = [this, observer](sqlite3* connection) {
+        if (observer)
+            sqlite3_trace_v2(connection, SQLITE_TRACE_PROFILE, &Storage::trace_statement, this);
+        else
+            sqlite3_trace_v2(connection, 0, nullptr, nullptr);
+    };
+    trace(db);
+    for (const auto& reader : read_connections)
+        trace(reader->db);
+}
+
+int Storage::trace_statement(unsigned event, void* storage, void* stmt, void* nanoseconds)
+{
+    Storage* self = static_cast<Storage*>(storage);
+    if (event == SQLITE_TRACE_PROFILE && self->statement_observer && std::this_thread::get_id() == self->statement_observer_thread)
+    {
+        const char* sql = sqlite3_sql(static_cast<sqlite3_stmt*>(stmt));
+        const double ms = static_cast<double>(*static_cast<sqlite3_int64*>(nanoseconds)) / 1e6;
+        self->statement_observer(self->statement_observer_context, sql ? sql : "", ms);
+    }
+    return 0;
+}
+
 //save the account info to the database
-void Storage::save_account_info(Account &acc)
+std::optional<Storage_changes> Storage::save_account_info(Account &acc)
 {
     const char* sql_account_type;
     int sql_account_money;
@@ -110,14 +623,15 @@ void Storage::save_account_info(Account &acc)
 
     sql_account_type = account_type_to_string(acc.read_account_type());
 
-    const char* tail;
     const char* instructions = 
     R"(INSERT INTO accounts(money_amount, account_name, account_type, initial_money_amount, is_asset, interest_rate, compounding_frequency, principal, term, monthly_payment, remaining_balance, remaining_term, remaining_interest, remaining_principal, remaining_total, credit_limit, minimum_payment)
     VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);
     )";
-    sqlite3_stmt* stmt;
-
-    sqlite3_prepare_v2(db, instructions, -1, &stmt, &tail);
+    sqlite3_stmt* stmt = get_prepared_statement(instructions);
+    if (!stmt) {
+        std::cerr << "save_account_info prepare failed: " << sqlite3_errmsg(db) << std::endl;
+        return std::nullopt;
+    }
 
     sqlite3_bind_int(stmt, 1, sql_account_money);
     sqlite3_bind_text(stmt, 2, sql_account_name, -1, SQLITE_TRANSIENT);
@@ -154,9 +668,12 @@ void Storage::save_account_info(Account &acc)
         sqlite3_bind_int(stmt, 16, acc.read_credit_limit());
         sqlite3_bind_int(stmt, 17, acc.read_minimum_payment());
     }
-    sqlite3_step(stmt);
-
-    sqlite3_finalize(stmt);
+    rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+    if (rc != SQLITE_DONE) {
+        std::cerr << "save_account_info INSERT failed: " << sqlite3_errmsg(db) << std::endl;
+        return std::nullopt;
+    }
 
     //create the account info object
     Account_info acc_info;
@@ -180,25 +697,29 @@ void Storage::save_account_info(Account &acc)
     acc_info.minimum_payment = acc.read_minimum_payment();
     //set Account's id 
     acc.set_account_id(acc_info.account_id);
-    accounts_vec.push_back(acc_info);
+
+    Storage_changes changes;
+    changes.accounts_saved.push_back(std::move(acc_info));
+    cache_changes(changes, Summary_update::patch);
+    return changes;
 };
 
 //check if the database is empty
 bool Storage::empty()
 {
-    sqlite3_stmt* stmt;
     const char* instructions = "SELECT COUNT(*) FROM accounts;";
     int count = 0;
 
-    if (sqlite3_prepare_v2(db, instructions, -1, &stmt, NULL) == SQLITE_OK) 
+    sqlite3_stmt* stmt = get_prepared_statement(instructions);
+    if (stmt) 
     {
         if (sqlite3_step(stmt) == SQLITE_ROW) 
         {
             count = sqlite3_column_int(stmt, 0);
         }
+        sqlite3_reset(stmt);
     }
 
-    sqlite3_finalize(stmt); 
 
     return (count == 0);
 }
@@ -207,46 +728,29 @@ std::vector<Account_info> Storage::load_accounts()
 {
     accounts_vec.clear();
 
-    sqlite3_stmt* stmt;
     const char* instructions = "SELECT * FROM accounts;";
-    int rc;
 
-    rc = sqlite3_prepare_v2(db, instructions, -1, &stmt, NULL);
+    sqlite3_stmt* stmt = get_prepared_statement(instructions);
+    if (!stmt) {
+        std::cerr << "load_accounts prepare failed: " << sqlite3_errmsg(db) << std::endl;
+        return accounts_vec;
+    }
 
     while (sqlite3_step(stmt) == SQLITE_ROW)
-    {
-        Account_info acc_info;
-        acc_info.account_id = sqlite3_column_int(stmt, 0);
-        acc_info.money_amount = sqlite3_column_int(stmt, 1);
-        acc_info.account_name = std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)));
-        acc_info.account_type = std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)));
-        acc_info.initial_money_amount = (sqlite3_column_count(stmt) > 4) ? sqlite3_column_int(stmt, 4) : 0;
-        acc_info.is_asset = (sqlite3_column_count(stmt) > 5) ? sqlite3_column_int(stmt, 5) : 0;
-        acc_info.interest_rate = (sqlite3_column_count(stmt) > 6) ? sqlite3_column_int(stmt, 6) : 0;
-        acc_info.compounding_frequency = (sqlite3_column_count(stmt) > 7) ? sqlite3_column_int(stmt, 7) : 0;
-        acc_info.principal = (sqlite3_column_count(stmt) > 8) ? sqlite3_column_int(stmt, 8) : 0;
-        acc_info.term = (sqlite3_column_count(stmt) > 9) ? sqlite3_column_int(stmt, 9) : 0;
-        acc_info.monthly_payment = (sqlite3_column_count(stmt) > 10) ? sqlite3_column_int(stmt, 10) : 0;
-        acc_info.remaining_balance = (sqlite3_column_count(stmt) > 11) ? sqlite3_column_int(stmt, 11) : 0;
-        acc_info.remaining_term = (sqlite3_column_count(stmt) > 12) ? sqlite3_column_int(stmt, 12) : 0;
-        acc_info.remaining_interest = (sqlite3_column_count(stmt) > 13) ? sqlite3_column_int(stmt, 13) : 0;
-        acc_info.remaining_principal = (sqlite3_column_count(stmt) > 14) ? sqlite3_column_int(stmt, 14) : 0;
-        acc_info.remaining_total = (sqlite3_column_count(stmt) > 15) ? sqlite3_column_int(stmt, 15) : 0;
-        acc_info.credit_limit = (sqlite3_column_count(stmt) > 16) ? sqlite3_column_int(stmt, 16) : 0;
-        acc_info.minimum_payment = (sqlite3_column_count(stmt) > 17) ? sqlite3_column_int(stmt, 17) : 0;
-        accounts_vec.push_back(acc_info);
-    }
-
-    sqlite3_finalize(stmt);
+        accounts_vec.push_back(account_info_from_stmt(stmt));
+
+    sqlite3_reset(stmt);
 
     return accounts_vec;
 }
 
-void Storage::save_transaction_info(int account_id, Transaction_info &trans)
+//insert the row and apply it to the balance and rollups under one transaction. Text is bound
+//SQLITE_STATIC: trans outlives the step, so SQLite reads the strings in place instead of copying.
+bool Storage::insert_transaction(int account_id, Transaction_info &trans)
 {
     if (!db) {
-        std::cerr << "save_transaction_info: database not open" << std::endl;
-        return;
+        std::cerr << "insert_transaction: database not open" << std::endl;
+        return false;
     }
 
     const char* sql_transaction_type = transaction_type_to_string(trans.type_of_transaction);
@@ -262,7 +766,6 @@ void Storage::save_transaction_info(int account_id, Transaction_info &trans)
         sql_transaction_category = transaction_category_want_to_string(trans.transaction_category_want);
     }
 
-    const char* tail;
     const char* instructions =
     R"(INSERT INTO transactions_table(account_id, transaction_amount, transaction_type, previous_amount, new_amount, transaction_date, transaction_name, note, transaction_category)
     VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?);
@@ -274,7 +777,7 @@ void Storage::save_transaction_info(int account_id, Transaction_info &trans)
         char* rollback_err = nullptr;
         int rollback_rc = sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, &rollback_err);
         if (rollback_rc != SQLITE_OK) {
-            std::cerr << "save_transaction_info ROLLBACK failed: "
+            std::cerr << "insert_transaction ROLLBACK failed: "
                       << (rollback_err ? rollback_err : sqlite3_errmsg(db)) << std::endl;
             sqlite3_free(rollback_err);
         }
@@ -283,75 +786,115 @@ void Storage::save_transaction_info(int account_id, Transaction_info &trans)
     char* begin_err = nullptr;
     int rc = sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, &begin_err);
     if (rc != SQLITE_OK) {
-        std::cerr << "save_transaction_info BEGIN failed: "
+        std::cerr << "insert_transaction BEGIN failed: "
                   << (begin_err ? begin_err : sqlite3_errmsg(db)) << std::endl;
         sqlite3_free(begin_err);
-        return;
+        return false;
     }
 
-    rc = sqlite3_prepare_v2(db, instructions, -1, &stmt, &tail);
-    if (rc != SQLITE_OK) {
-        std::cerr << "save_transaction_info prepare failed: " << sqlite3_errmsg(db) << std::endl;
+    // Apply the amount to the stored balance as a delta. The caller's previous/new amounts were
+    // worked out from the balance on screen, which can be behind writes still queued ahead of this
+    // one; the row records the balance this commit actually moved.
+    const char* update_sql = "UPDATE accounts SET money_amount = money_amount + ? WHERE id = ? RETURNING money_amount;";
+    update_stmt = get_prepared_statement(update_sql);
+    if (!update_stmt) {
+        std::cerr << "insert_transaction UPDATE prepare failed: " << sqlite3_errmsg(db) << std::endl;
         rollback_transaction();
-        return;
+        return false;
+    }
+    sqlite3_bind_int(update_stmt, 1, trans.transaction_amount);
+    sqlite3_bind_int(update_stmt, 2, account_id);
+    rc = sqlite3_step(update_stmt);
+    if (rc == SQLITE_ROW) {
+        trans.account_new_amount = sqlite3_column_int(update_stmt, 0);
+        trans.account_previous_amount = trans.account_new_amount - trans.transaction_amount;
+        rc = sqlite3_step(update_stmt);
+    } else if (rc == SQLITE_DONE) {
+        rc = SQLITE_NOTFOUND;   // no such account
+    }
+    sqlite3_reset(update_stmt);
+    if (rc != SQLITE_DONE) {
+        std::cerr << "insert_transaction UPDATE failed: " << sqlite3_errmsg(db) << std::endl;
+        rollback_transaction();
+        return false;
+    }
+
+    stmt = get_prepared_statement(instructions);
+    if (!stmt) {
+        std::cerr << "insert_transaction prepare failed: " << sqlite3_errmsg(db) << std::endl;
+        rollback_transaction();
+        return false;
     }
 
     sqlite3_bind_int(stmt, 1, account_id);
     sqlite3_bind_int(stmt, 2, trans.transaction_amount);
-    sqlite3_bind_text(stmt, 3, sql_transaction_type, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 3, sql_transaction_type, -1, SQLITE_STATIC);
     sqlite3_bind_int(stmt, 4, trans.account_previous_amount);
     sqlite3_bind_int(stmt, 5, trans.account_new_amount);
     sqlite3_bind_int(stmt, 6, static_cast<int>(trans.ymd));
-    sqlite3_bind_text(stmt, 7, trans.transaction_name.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 8, trans.note.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 9, sql_transaction_category, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 7, trans.transaction_name.data(), static_cast<int>(trans.transaction_name.size()), SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 8, trans.note.data(), static_cast<int>(trans.note.size()), SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 9, sql_transaction_category, -1, SQLITE_STATIC);
 
     rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
-        std::cerr << "save_transaction_info INSERT failed: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_reset(stmt);
+        std::cerr << "insert_transaction INSERT failed: " << sqlite3_errmsg(db) << std::endl;
         rollback_transaction();
-        return;
+        return false;
     }
     trans.transaction_id = static_cast<int>(sqlite3_last_insert_rowid(db));
-    sqlite3_finalize(stmt);
+    sqlite3_reset(stmt);
 
-    // Update the account balance in the accounts table
-    const char* update_sql = "UPDATE accounts SET money_amount = ? WHERE id = ?;";
-    rc = sqlite3_prepare_v2(db, update_sql, -1, &update_stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "save_transaction_info UPDATE prepare failed: " << sqlite3_errmsg(db) << std::endl;
-        rollback_transaction();
-        return;
-    }
-    sqlite3_bind_int(update_stmt, 1, trans.account_new_amount);
-    sqlite3_bind_int(update_stmt, 2, account_id);
-    rc = sqlite3_step(update_stmt);
-    sqlite3_finalize(update_stmt);
-    if (rc != SQLITE_DONE) {
-        std::cerr << "save_transaction_info UPDATE failed: " << sqlite3_errmsg(db) << std::endl;
+    if (!add_to_monthly_rollup(account_id, trans.ymd, trans.transaction_amount, 1)) {
         rollback_transaction();
-        return;
+        return false;
     }
 
     char* commit_err = nullptr;
     rc = sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &commit_err);
     if (rc != SQLITE_OK) {
-        std::cerr << "save_transaction_info COMMIT failed: "
+        std::cerr << "insert_transaction COMMIT failed: "
                   << (commit_err ? commit_err : sqlite3_errmsg(db)) << std::endl;
         sqlite3_free(commit_err);
         rollback_transaction();
-        return;
+        return false;
     }
 
+    trans.account_id = account_id;
+    return true;
+}
+
+std::optional<Storage_changes> Storage::save_transaction_info(int account_id, Transaction_info &trans)
+{
+    if (!insert_transaction(account_id, trans))
+        return std::nullopt;
+
     // Keep in-memory cache in sync only after both DB writes commit.
-    transactions_by_account[account_id].push_back(trans);
+    Storage_changes changes;
+    changes.balances.push_back({account_id, trans.account_new_amount});
+    changes.inserted.push_back(trans);
+    cache_changes(changes, Summary_update::patch);
+    return changes;
+}
+
+std::optional<Storage_changes> Storage::save_transaction_info(int account_id, Transaction_info &&trans)
+{
+    if (!insert_transaction(account_id, trans))
+        return std::nullopt;
+
+    Storage_changes changes;
+    changes.balances.push_back({account_id, trans.account_new_amount});
+    changes.inserted.push_back(std::move(trans));
+    cache_changes(changes, Summary_update::patch);
+    return changes;
 }
-void Storage::save_internal_transfer(int account_id_from, int account_id_to, Transaction_info &trans)
+
+std::optional<Storage_changes> Storage::save_internal_transfer(int account_id_from, int account_id_to, Transaction_info trans)
 {
     if (!db) {
         std::cerr << "save_internal_transfer: database not open" << std::endl;
-        return;
+        return std::nullopt;
     }
 
     const char* sql_transaction_type = transaction_type_to_string(trans.type_of_transaction);
@@ -372,23 +915,22 @@ void Storage::save_internal_transfer(int account_id_from, int account_id_to, Tra
         std::cerr << "save_internal_transfer BEGIN failed: "
                   << (begin_err ? begin_err : sqlite3_errmsg(db)) << std::endl;
         sqlite3_free(begin_err);
-        return;
+        return std::nullopt;
     }
 
     // Read current balance and is_asset for an account within this transaction
     auto read_account = [this](int account_id, int &balance, bool &is_asset) -> bool {
-        sqlite3_stmt* stmt = nullptr;
         const char* sql = "SELECT money_amount, is_asset FROM accounts WHERE id = ?;";
-        int rc = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
-        if (rc != SQLITE_OK) return false;
+        sqlite3_stmt* stmt = get_prepared_statement(sql);
+        if (!stmt) return false;
         sqlite3_bind_int(stmt, 1, account_id);
         if (sqlite3_step(stmt) != SQLITE_ROW) {
-            sqlite3_finalize(stmt);
+            sqlite3_reset(stmt);
             return false;
         }
         balance = sqlite3_column_int(stmt, 0);
         is_asset = sqlite3_column_int(stmt, 1) != 0;
-        sqlite3_finalize(stmt);
+        sqlite3_reset(stmt);
         return true;
     };
 
@@ -399,7 +941,7 @@ void Storage::save_internal_transfer(int account_id_from, int account_id_to, Tra
         !read_account(account_id_to, to_balance, to_is_asset)) {
         std::cerr << "save_internal_transfer: failed to read account info" << std::endl;
         rollback_transaction();
-        return;
+        return std::nullopt;
     }
 
     int transfer_amount = std::abs(trans.transaction_amount);
@@ -416,94 +958,96 @@ void Storage::save_internal_transfer(int account_id_from, int account_id_to, Tra
     VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?);
     )";
 
-    sqlite3_stmt* stmt = nullptr;
-    rc = sqlite3_prepare_v2(db, insert_sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    sqlite3_stmt* stmt = get_prepared_statement(insert_sql);
+    if (!stmt) {
         std::cerr << "save_internal_transfer INSERT (from) prepare failed: " << sqlite3_errmsg(db) << std::endl;
         rollback_transaction();
-        return;
+        return std::nullopt;
     }
     sqlite3_bind_int(stmt, 1, account_id_from);
     sqlite3_bind_int(stmt, 2, from_delta);
-    sqlite3_bind_text(stmt, 3, sql_transaction_type, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 3, sql_transaction_type, -1, SQLITE_STATIC);
     sqlite3_bind_int(stmt, 4, from_balance);
     sqlite3_bind_int(stmt, 5, new_from_balance);
     sqlite3_bind_int(stmt, 6, static_cast<int>(trans.ymd));
-    sqlite3_bind_text(stmt, 7, trans.transaction_name.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 8, trans.note.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 7, trans.transaction_name.data(), static_cast<int>(trans.transaction_name.size()), SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 8, trans.note.data(), static_cast<int>(trans.note.size()), SQLITE_STATIC);
     sqlite3_bind_null(stmt, 9);
     rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
+        sqlite3_reset(stmt);
         std::cerr << "save_internal_transfer INSERT (from) failed: " << sqlite3_errmsg(db) << std::endl;
         rollback_transaction();
-        return;
+        return std::nullopt;
     }
     int from_transaction_id = static_cast<int>(sqlite3_last_insert_rowid(db));
-    sqlite3_finalize(stmt);
+    sqlite3_reset(stmt);
 
     // Insert transaction row for destination account
-    stmt = nullptr;
-    rc = sqlite3_prepare_v2(db, insert_sql, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    stmt = get_prepared_statement(insert_sql);
+    if (!stmt) {
         std::cerr << "save_internal_transfer INSERT (to) prepare failed: " << sqlite3_errmsg(db) << std::endl;
         rollback_transaction();
-        return;
+        return std::nullopt;
     }
     sqlite3_bind_int(stmt, 1, account_id_to);
     sqlite3_bind_int(stmt, 2, to_delta);
-    sqlite3_bind_text(stmt, 3, sql_transaction_type, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 3, sql_transaction_type, -1, SQLITE_STATIC);
     sqlite3_bind_int(stmt, 4, to_balance);
     sqlite3_bind_int(stmt, 5, new_to_balance);
     sqlite3_bind_int(stmt, 6, static_cast<int>(trans.ymd));
-    sqlite3_bind_text(stmt, 7, trans.transaction_name.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 8, trans.note.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 7, trans.transaction_name.data(), static_cast<int>(trans.transaction_name.size()), SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 8, trans.note.data(), static_cast<int>(trans.note.size()), SQLITE_STATIC);
     sqlite3_bind_null(stmt, 9);
     rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
+        sqlite3_reset(stmt);
         std::cerr << "save_internal_transfer INSERT (to) failed: " << sqlite3_errmsg(db) << std::endl;
         rollback_transaction();
-        return;
+        return std::nullopt;
     }
     int to_transaction_id = static_cast<int>(sqlite3_last_insert_rowid(db));
-    sqlite3_finalize(stmt);
+    sqlite3_reset(stmt);
 
     // Update source account balance
     const char* update_sql = "UPDATE accounts SET money_amount = ? WHERE id = ?;";
-    sqlite3_stmt* update_stmt = nullptr;
-    rc = sqlite3_prepare_v2(db, update_sql, -1, &update_stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    sqlite3_stmt* update_stmt = get_prepared_statement(update_sql);
+    if (!update_stmt) {
         std::cerr << "save_internal_transfer UPDATE (from) prepare failed: " << sqlite3_errmsg(db) << std::endl;
         rollback_transaction();
-        return;
+        return std::nullopt;
     }
     sqlite3_bind_int(update_stmt, 1, new_from_balance);
     sqlite3_bind_int(update_stmt, 2, account_id_from);
     rc = sqlite3_step(update_stmt);
-    sqlite3_finalize(update_stmt);
+    sqlite3_reset(update_stmt);
     if (rc != SQLITE_DONE) {
         std::cerr << "save_internal_transfer UPDATE (from) failed: " << sqlite3_errmsg(db) << std::endl;
         rollback_transaction();
-        return;
+        return std::nullopt;
     }
 
     // Update destination account balance
-    update_stmt = nullptr;
-    rc = sqlite3_prepare_v2(db, update_sql, -1, &update_stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    update_stmt = get_prepared_statement(update_sql);
+    if (!update_stmt) {
         std::cerr << "save_internal_transfer UPDATE (to) prepare failed: " << sqlite3_errmsg(db) << std::endl;
         rollback_transaction();
-        return;
+        return std::nullopt;
     }
     sqlite3_bind_int(update_stmt, 1, new_to_balance);
     sqlite3_bind_int(update_stmt, 2, account_id_to);
     rc = sqlite3_step(update_stmt);
-    sqlite3_finalize(update_stmt);
+    sqlite3_reset(update_stmt);
     if (rc != SQLITE_DONE) {
         std::cerr << "save_internal_transfer UPDATE (to) failed: " << sqlite3_errmsg(db) << std::endl;
         rollback_transaction();
-        return;
+        return std::nullopt;
+    }
+
+    if (!add_to_monthly_rollup(account_id_from, trans.ymd, from_delta, 1) ||
+        !add_to_monthly_rollup(account_id_to, trans.ymd, to_delta, 1)) {
+        rollback_transaction();
+        return std::nullopt;
     }
 
     char* commit_err = nullptr;
@@ -513,208 +1057,781 @@ void Storage::save_internal_transfer(int account_id_from, int account_id_to, Tra
                   << (commit_err ? commit_err : sqlite3_errmsg(db)) << std::endl;
         sqlite3_free(commit_err);
         rollback_transaction();
-        return;
+        return std::nullopt;
     }
 
-    // Update in-memory cache for both accounts after successful commit
-    Transaction_info from_trans;
-    from_trans.transaction_id = from_transaction_id;
-    from_trans.account_id = account_id_from;
-    from_trans.transaction_amount = from_delta;
-    from_trans.type_of_transaction = Transaction_type::Internal_transfer;
-    from_trans.transaction_category_need = Transaction_category_need::Other;
-    from_trans.transaction_category_want = Transaction_category_want::Other;
-    from_trans.account_previous_amount = from_balance;
-    from_trans.account_new_amount = new_from_balance;
-    from_trans.ymd = trans.ymd;
+    // Update in-memory cache for both accounts after successful commit. The source row copies the
+    // name and note; the destination row, built last, takes trans's own strings.
+    auto transfer_row = [&trans](int transaction_id, int account_id, int amount, int previous, int current) {
+        Transaction_info row;
+        row.transaction_id = transaction_id;
+        row.account_id = account_id;
+        row.transaction_amount = amount;
+        row.type_of_transaction = Transaction_type::Internal_transfer;
+        row.transaction_category_need = Transaction_category_need::Other;
+        row.transaction_category_want = Transaction_category_want::Other;
+        row.account_previous_amount = previous;
+        row.account_new_amount = current;
+        row.ymd = trans.ymd;
+        return row;
+    };
+
+    Storage_changes changes;
+    changes.balances.push_back({account_id_from, new_from_balance});
+    changes.balances.push_back({account_id_to, new_to_balance});
+
+    Transaction_info from_trans = transfer_row(from_transaction_id, account_id_from, from_delta, from_balance, new_from_balance);
     from_trans.transaction_name = trans.transaction_name;
     from_trans.note = trans.note;
-    transactions_by_account[account_id_from].push_back(from_trans);
-
-    Transaction_info to_trans;
-    to_trans.transaction_id = to_transaction_id;
-    to_trans.account_id = account_id_to;
-    to_trans.transaction_amount = to_delta;
-    to_trans.type_of_transaction = Transaction_type::Internal_transfer;
-    to_trans.transaction_category_need = Transaction_category_need::Other;
-    to_trans.transaction_category_want = Transaction_category_want::Other;
-    to_trans.account_previous_amount = to_balance;
-    to_trans.account_new_amount = new_to_balance;
-    to_trans.ymd = trans.ymd;
-    to_trans.transaction_name = trans.transaction_name;
-    to_trans.note = trans.note;
-    transactions_by_account[account_id_to].push_back(to_trans);
+    changes.inserted.push_back(std::move(from_trans));
+
+    Transaction_info to_trans = transfer_row(to_transaction_id, account_id_to, to_delta, to_balance, new_to_balance);
+    to_trans.transaction_name = std::move(trans.transaction_name);
+    to_trans.note = std::move(trans.note);
+    changes.inserted.push_back(std::move(to_trans));
+
+    cache_changes(changes, Summary_update::patch);
+    return changes;
+}
+
+//insert many transactions for one account under a single transaction. Running balances are
+//computed here from the account's current balance (account_previous_amount/account_new_amount
+//on the inputs are overwritten), the balance and each month's rollup are written once, and
+//transaction ids are filled in.
+std::optional<Storage_changes> Storage::save_transactions_batch(int account_id, std::span<Transaction_info> transactions)
+{
+    if (!db) {
+        std::cerr << "save_transactions_batch: database not open" << std::endl;
+        return std::nullopt;
+    }
+
+    auto rollback_transaction = [this]() {
+        char* rollback_err = nullptr;
+        int rollback_rc = sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, &rollback_err);
+        if (rollback_rc != SQLITE_OK) {
+            std::cerr << "save_transactions_batch ROLLBACK failed: "
+                      << (rollback_err ? rollback_err : sqlite3_errmsg(db)) << std::endl;
+            sqlite3_free(rollback_err);
+        }
+    };
+
+    char* begin_err = nullptr;
+    int rc = sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, &begin_err);
+    if (rc != SQLITE_OK) {
+        std::cerr << "save_transactions_batch BEGIN failed: "
+                  << (begin_err ? begin_err : sqlite3_errmsg(db)) << std::endl;
+        sqlite3_free(begin_err);
+        return std::nullopt;
+    }
+
+    sqlite3_stmt* balance_stmt = get_prepared_statement("SELECT money_amount FROM accounts WHERE id = ?;");
+    if (!balance_stmt) {
+        std::cerr << "save_transactions_batch SELECT prepare failed: " << sqlite3_errmsg(db) << std::endl;
+        rollback_transaction();
+        return std::nullopt;
+    }
+    sqlite3_bind_int(balance_stmt, 1, account_id);
+    if (sqlite3_step(balance_stmt) != SQLITE_ROW) {
+        sqlite3_reset(balance_stmt);
+        std::cerr << "save_transactions_batch: unknown account " << account_id << std::endl;
+        rollback_transaction();
+        return std::nullopt;
+    }
+    int running_balance = sqlite3_column_int(balance_stmt, 0);
+    sqlite3_reset(balance_stmt);
+
+    const char* instructions =
+    R"(INSERT INTO transactions_table(account_id, transaction_amount, transaction_type, previous_amount, new_amount, transaction_date, transaction_name, note, transaction_category)
+    VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?);
+    )";
+    sqlite3_stmt* stmt = get_prepared_statement(instructions);
+    if (!stmt) {
+        std::cerr << "save_transactions_batch prepare failed: " << sqlite3_errmsg(db) << std::endl;
+        rollback_transaction();
+        return std::nullopt;
+    }
+
+    // month -> totals, so each touched rollup row is written once
+    std::map<int, Monthly_rollup> rollup_deltas;
+    for (Transaction_info& trans : transactions)
+    {
+        trans.account_id = account_id;
+        trans.account_previous_amount = running_balance;
+        running_balance += trans.transaction_amount;
+        trans.account_new_amount = running_balance;
+
+        const char* sql_transaction_category = nullptr;
+        if (trans.type_of_transaction == Transaction_type::Need)
+            sql_transaction_category = transaction_category_need_to_string(trans.transaction_category_need);
+        else if (trans.type_of_transaction == Transaction_type::Want)
+            sql_transaction_category = transaction_category_want_to_string(trans.transaction_category_want);
+
+        sqlite3_bind_int(stmt, 1, account_id);
+        sqlite3_bind_int(stmt, 2, trans.transaction_amount);
+        sqlite3_bind_text(stmt, 3, transaction_type_to_string(trans.type_of_transaction), -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 4, trans.account_previous_amount);
+        sqlite3_bind_int(stmt, 5, trans.account_new_amount);
+        sqlite3_bind_int(stmt, 6, static_cast<int>(trans.ymd));
+        sqlite3_bind_text(stmt, 7, trans.transaction_name.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 8, trans.note.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 9, sql_transaction_category, -1, SQLITE_STATIC);
+
+        rc = sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+        if (rc != SQLITE_DONE) {
+            std::cerr << "save_transactions_batch INSERT failed: " << sqlite3_errmsg(db) << std::endl;
+            rollback_transaction();
+            return std::nullopt;
+        }
+        trans.transaction_id = static_cast<int>(sqlite3_last_insert_rowid(db));
+
+        Monthly_rollup& rollup = rollup_deltas[year_month_from_time(trans.ymd)];
+        if (trans.transaction_amount > 0)
+            rollup.money_in += trans.transaction_amount;
+        else
+            rollup.money_out += std::abs(trans.transaction_amount);
+        rollup.txn_count++;
+    }
+
+    for (const auto& [year_month, rollup] : rollup_deltas)
+    {
+        if (!upsert_monthly_rollup(account_id, year_month, rollup.money_in, rollup.money_out, rollup.txn_count)) {
+            rollback_transaction();
+            return std::nullopt;
+        }
+    }
+
+    sqlite3_stmt* update_stmt = get_prepared_statement("UPDATE accounts SET money_amount = ? WHERE id = ?;");
+    if (!update_stmt) {
+        std::cerr << "save_transactions_batch UPDATE prepare failed: " << sqlite3_errmsg(db) << std::endl;
+        rollback_transaction();
+        return std::nullopt;
+    }
+    sqlite3_bind_int(update_stmt, 1, running_balance);
+    sqlite3_bind_int(update_stmt, 2, account_id);
+    rc = sqlite3_step(update_stmt);
+    sqlite3_reset(update_stmt);
+    if (rc != SQLITE_DONE) {
+        std::cerr << "save_transactions_batch UPDATE failed: " << sqlite3_errmsg(db) << std::endl;
+        rollback_transaction();
+        return std::nullopt;
+    }
+
+    char* commit_err = nullptr;
+    rc = sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &commit_err);
+    if (rc != SQLITE_OK) {
+        std::cerr << "save_transactions_batch COMMIT failed: "
+                  << (commit_err ? commit_err : sqlite3_errmsg(db)) << std::endl;
+        sqlite3_free(commit_err);
+        rollback_transaction();
+        return std::nullopt;
+    }
+
+    // Keep in-memory state in sync only after the commit
+    Storage_changes changes;
+    changes.balances.push_back({account_id, running_balance});
+    changes.inserted.assign(transactions.begin(), transactions.end());
+    if (cache_writes)
+        reserve_transactions(account_id, get_transactions(account_id).size() + transactions.size());
+    cache_changes(changes, Summary_update::patch);
+    return changes;
 }
 
 void Storage::load_transactions(int account_id)
 {
     transactions_by_account[account_id].clear();
 
-    sqlite3_stmt* stmt = nullptr;
-    const char* instructions = "SELECT * FROM transactions_table WHERE account_id = ?;";
-    int rc = sqlite3_prepare_v2(db, instructions, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    const char* instructions =
+    R"(SELECT id, account_id, transaction_amount, transaction_type, previous_amount, new_amount, transaction_date, transaction_name, transaction_category
+    FROM transactions_table WHERE account_id = ? ORDER BY id;)";
+    sqlite3_stmt* stmt = get_prepared_statement(instructions);
+    if (!stmt) {
         std::cerr << "load_transactions prepare failed: " << sqlite3_errmsg(db) << std::endl;
         return;
     }
     sqlite3_bind_int(stmt, 1, account_id);
+    Account_transactions& cached = transactions_by_account[account_id];
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        Transaction_info trans_info = get_transaction_info_from_stmt(stmt);
-        transactions_by_account[account_id].push_back(trans_info);
+        cached.append(get_transaction_row_from_stmt(stmt));
     }
-    sqlite3_finalize(stmt);
+    sqlite3_reset(stmt);
+    cached.index_dates();
 }
 
 void Storage::load_all_transactions()
 {
     transactions_by_account.clear();
+    month_summaries.clear();
 
-    sqlite3_stmt* stmt = nullptr;
-    const char* instructions = "SELECT * FROM transactions_table ORDER BY account_id, id;";
-    int rc = sqlite3_prepare_v2(db, instructions, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    // notes are usually the bulk of a row's text and are only shown when a row is expanded
+    const char* instructions =
+    R"(SELECT id, account_id, transaction_amount, transaction_type, previous_amount, new_amount, transaction_date, transaction_name, transaction_category
+    FROM transactions_table ORDER BY account_id, id;)";
+    sqlite3_stmt* stmt = get_prepared_statement(instructions);
+    if (!stmt) {
         std::cerr << "load_all_transactions prepare failed: " << sqlite3_errmsg(db) << std::endl;
         return;
     }
+    // rows come grouped by account, so only look the account up when it changes
+    Account_transactions* cached = nullptr;
+    int cached_account_id = 0;
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        Transaction_info trans_info = get_transaction_info_from_stmt(stmt);
-        transactions_by_account[trans_info.account_id].push_back(trans_info);
+        Transaction_row row = get_transaction_row_from_stmt(stmt);
+        if (!cached || row.account_id != cached_account_id) {
+            cached = &transactions_by_account[row.account_id];
+            cached_account_id = row.account_id;
+        }
+        cached->append(row);
+    }
+    sqlite3_reset(stmt);
+    for (auto& [id, list] : transactions_by_account)
+        list.index_dates();
+    all_transactions_cached = true;
+}
+
+std::string_view Storage::get_transaction_note(int account_id, int transaction_id)
+{
+    std::string_view empty;
+    auto cached = transactions_by_account.find(account_id);
+    if (cached == transactions_by_account.end())
+        return empty;
+    Account_transactions& list = cached->second;
+    size_t index = list.find(transaction_id);
+    if (index == list.size())
+        return empty;
+    if (list[index].note_loaded)
+        return list[index].note;
+
+    const char* instructions = "SELECT note FROM transactions_table WHERE id = ?;";
+    sqlite3_stmt* stmt = get_prepared_statement(instructions);
+    if (!stmt) {
+        std::cerr << "get_transaction_note prepare failed: " << sqlite3_errmsg(db) << std::endl;
+        return empty;
+    }
+    sqlite3_bind_int(stmt, 1, transaction_id);
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* note_p = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        list.set_note(index, note_p ? note_p : "");
+    }
+    sqlite3_reset(stmt);
+    return list[index].note;
+}
+
+std::optional<int> Storage_changes::balance_of(int account_id) const
+{
+    for (const Balance& balance : balances)
+        if (balance.account_id == account_id)
+            return balance.money_amount;
+    return std::nullopt;
+}
+
+//a write committed by another connection may already be counted in a month summary: a summary
+//read after that commit and before this call sees it. Drop the months it touched and re-read them.
+void Storage::apply_changes(const Storage_changes& changes)
+{
+    cache_changes(changes, Summary_update::drop);
+}
+
+//mirror a committed write into the in-memory cache
+void Storage::cache_changes(const Storage_changes& changes, Summary_update summaries)
+{
+    if (!cache_writes)
+        return;
+
+    auto update_month = [this, summaries](int account_id, std::time_t ymd, int transaction_amount, int sign) {
+        if (summaries == Summary_update::patch)
+            apply_to_month_summaries(account_id, ymd, transaction_amount, sign);
+        else
+            month_summaries.erase(Month_summary_key{account_id, year_month_from_time(ymd)});
+    };
+
+    for (const Storage_changes::Removed_transaction& removed : changes.removed) {
+        update_month(removed.account_id, removed.ymd, removed.transaction_amount, -1);
+        auto cached = transactions_by_account.find(removed.account_id);
+        if (cached == transactions_by_account.end())
+            continue;
+        Account_transactions& list = cached->second;
+        size_t index = list.find(removed.transaction_id);
+        if (index != list.size())
+            list.erase(index);
+    }
+
+    for (const Transaction_info& trans : changes.inserted) {
+        transactions_by_account[trans.account_id].push_back(trans);
+        update_month(trans.account_id, trans.ymd, trans.transaction_amount, 1);
+    }
+
+    for (const Account_info& saved : changes.accounts_saved) {
+        auto existing = std::find_if(accounts_vec.begin(), accounts_vec.end(),
+            [&saved](const Account_info& acc_info) { return acc_info.account_id == saved.account_id; });
+        if (existing != accounts_vec.end())
+            *existing = saved;
+        else
+            accounts_vec.push_back(saved);
+    }
+
+    for (const Storage_changes::Balance& balance : changes.balances)
+        set_cached_balance(balance.account_id, balance.money_amount);
+
+    for (int account_id : changes.accounts_deleted) {
+        std::erase_if(accounts_vec, [account_id](const Account_info& acc_info) { return acc_info.account_id == account_id; });
+        invalidate_month_summaries(account_id);
+        transactions_by_account.erase(account_id);
+    }
+}
+
+void Storage::set_cached_balance(int account_id, int money_amount)
+{
+    for (Account_info& acc_info : accounts_vec) {
+        if (acc_info.account_id == account_id)
+            acc_info.money_amount = money_amount;
     }
-    sqlite3_finalize(stmt);
 }
 
-const std::vector<Transaction_info>& Storage::get_transactions(int account_id)
+const Account_transactions& Storage::get_transactions(int account_id)
 {
-    static const std::vector<Transaction_info> empty;
+    static const Account_transactions empty;
     auto it = transactions_by_account.find(account_id);
     if (it == transactions_by_account.end())
         return empty;
     return it->second;
 }
 
-void Storage::delete_transaction(int transaction_id, int account_id)
+void Storage::reserve_transactions(int account_id, size_t count)
 {
-    sqlite3_stmt* stmt = nullptr;
-    const char* instructions = "DELETE FROM transactions_table WHERE id = ?;";
-    int rc = sqlite3_prepare_v2(db, instructions, -1, &stmt, nullptr);
+    transactions_by_account[account_id].reserve(count);
+}
+
+Account_transactions::Date_range Storage::get_transactions_in_range(int account_id, std::time_t start_time, std::time_t end_time)
+{
+    return get_transactions(account_id).in_date_range(start_time, end_time);
+}
+
+//delete one transaction and apply its amount to the balance as a delta, so the cost does not
+//depend on how many rows the account has.
+std::optional<Storage_changes> Storage::delete_transaction(int transaction_id, int account_id)
+{
+    auto rollback_transaction = [this]() {
+        char* rollback_err = nullptr;
+        int rollback_rc = sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, &rollback_err);
+        if (rollback_rc != SQLITE_OK) {
+            std::cerr << "delete_transaction ROLLBACK failed: "
+                      << (rollback_err ? rollback_err : sqlite3_errmsg(db)) << std::endl;
+            sqlite3_free(rollback_err);
+        }
+    };
+
+    char* begin_err = nullptr;
+    int rc = sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, &begin_err);
     if (rc != SQLITE_OK) {
+        std::cerr << "delete_transaction BEGIN failed: "
+                  << (begin_err ? begin_err : sqlite3_errmsg(db)) << std::endl;
+        sqlite3_free(begin_err);
+        return std::nullopt;
+    }
+
+    // Read the row's amount and date: the amount is the balance delta, and both adjust the rollups
+    const char* row_sql = "SELECT transaction_amount, transaction_date FROM transactions_table WHERE id = ? AND account_id = ?;";
+    sqlite3_stmt* row_stmt = get_prepared_statement(row_sql);
+    if (!row_stmt) {
+        std::cerr << "delete_transaction SELECT prepare failed: " << sqlite3_errmsg(db) << std::endl;
+        rollback_transaction();
+        return std::nullopt;
+    }
+    sqlite3_bind_int(row_stmt, 1, transaction_id);
+    sqlite3_bind_int(row_stmt, 2, account_id);
+    if (sqlite3_step(row_stmt) != SQLITE_ROW) {
+        sqlite3_reset(row_stmt);
+        rollback_transaction();
+        return std::nullopt;
+    }
+    int removed_amount = sqlite3_column_int(row_stmt, 0);
+    std::time_t removed_ymd = static_cast<std::time_t>(sqlite3_column_int(row_stmt, 1));
+    sqlite3_reset(row_stmt);
+
+    const char* instructions = "DELETE FROM transactions_table WHERE id = ?;";
+    sqlite3_stmt* stmt = get_prepared_statement(instructions);
+    if (!stmt) {
         std::cerr << "delete_transaction prepare failed: " << sqlite3_errmsg(db) << std::endl;
-        return;
+        rollback_transaction();
+        return std::nullopt;
     }
     sqlite3_bind_int(stmt, 1, transaction_id);
     rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    sqlite3_reset(stmt);
     if (rc != SQLITE_DONE) {
         std::cerr << "delete_transaction failed: " << sqlite3_errmsg(db) << std::endl;
-        return;
-    }
-
-    // Get initial balance for this account (used when all transactions are deleted)
-    int initial_balance = 0;
-    sqlite3_stmt* init_stmt = nullptr;
-    const char* init_sql = "SELECT COALESCE(initial_money_amount, 0) FROM accounts WHERE id = ?;";
-    rc = sqlite3_prepare_v2(db, init_sql, -1, &init_stmt, nullptr);
-    if (rc == SQLITE_OK) {
-        sqlite3_bind_int(init_stmt, 1, account_id);
-        if (sqlite3_step(init_stmt) == SQLITE_ROW)
-            initial_balance = sqlite3_column_int(init_stmt, 0);
-        sqlite3_finalize(init_stmt);
+        rollback_transaction();
+        return std::nullopt;
     }
 
-    // Recalculate the account balance: initial + sum of remaining transactions
-    const char* sum_sql = "SELECT COALESCE(SUM(transaction_amount), 0) FROM transactions_table WHERE account_id = ?;";
-    sqlite3_stmt* sum_stmt = nullptr;
-    rc = sqlite3_prepare_v2(db, sum_sql, -1, &sum_stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "delete_transaction SUM prepare failed: " << sqlite3_errmsg(db) << std::endl;
-        return;
-    }
-    sqlite3_bind_int(sum_stmt, 1, account_id);
-    int transaction_sum = 0;
-    if (sqlite3_step(sum_stmt) == SQLITE_ROW) {
-        transaction_sum = sqlite3_column_int(sum_stmt, 0);
+    if (!add_to_monthly_rollup(account_id, removed_ymd, removed_amount, -1)) {
+        rollback_transaction();
+        return std::nullopt;
     }
-    sqlite3_finalize(sum_stmt);
-    int new_balance = initial_balance + transaction_sum;
 
-    // Update the account's balance in the accounts table
-    const char* update_sql = "UPDATE accounts SET money_amount = ? WHERE id = ?;";
-    sqlite3_stmt* update_stmt = nullptr;
-    rc = sqlite3_prepare_v2(db, update_sql, -1, &update_stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    // Take the removed amount back out of the balance
+    const char* update_sql = "UPDATE accounts SET money_amount = money_amount - ? WHERE id = ? RETURNING money_amount;";
+    sqlite3_stmt* update_stmt = get_prepared_statement(update_sql);
+    if (!update_stmt) {
         std::cerr << "delete_transaction UPDATE prepare failed: " << sqlite3_errmsg(db) << std::endl;
-        return;
+        rollback_transaction();
+        return std::nullopt;
     }
-    sqlite3_bind_int(update_stmt, 1, new_balance);
+    sqlite3_bind_int(update_stmt, 1, removed_amount);
     sqlite3_bind_int(update_stmt, 2, account_id);
+    int new_balance = 0;
     rc = sqlite3_step(update_stmt);
-    sqlite3_finalize(update_stmt);
+    if (rc == SQLITE_ROW) {
+        new_balance = sqlite3_column_int(update_stmt, 0);
+        rc = sqlite3_step(update_stmt);
+    }
+    sqlite3_reset(update_stmt);
     if (rc != SQLITE_DONE) {
         std::cerr << "delete_transaction UPDATE failed: " << sqlite3_errmsg(db) << std::endl;
-        return;
+        rollback_transaction();
+        return std::nullopt;
     }
 
-    // Refresh in-memory transactions cache for this account
-    load_transactions(account_id);
+    char* commit_err = nullptr;
+    rc = sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &commit_err);
+    if (rc != SQLITE_OK) {
+        std::cerr << "delete_transaction COMMIT failed: "
+                  << (commit_err ? commit_err : sqlite3_errmsg(db)) << std::endl;
+        sqlite3_free(commit_err);
+        rollback_transaction();
+        return std::nullopt;
+    }
+
+    // Patch the in-memory state instead of reloading the account
+    Storage_changes changes;
+    changes.balances.push_back({account_id, new_balance});
+    changes.removed.push_back({account_id, transaction_id, removed_amount, removed_ymd});
+    cache_changes(changes, Summary_update::patch);
+    return changes;
 }
 
-std::vector<Transaction_info> Storage::get_monthly_information(int account_id, std::time_t start_time, std::time_t end_time)
+std::vector<Transaction_info> Storage::get_monthly_information(int account_id, std::time_t start_time, std::time_t end_time,
+    Transaction_columns columns)
 {
     std::vector<Transaction_info> monthly_transactions;
-    sqlite3_stmt* stmt = nullptr;
-    const char* instructions = "SELECT * FROM transactions_table WHERE account_id = ? AND transaction_date >= ? AND transaction_date < ?;";
-    int rc = sqlite3_prepare_v2(db, instructions, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        std::cerr << "load_all_transactions prepare failed: " << sqlite3_errmsg(db) << std::endl;
+    const char* instructions = nullptr;
+    switch (columns) {
+    case Transaction_columns::summary:
+        instructions =
+        R"(SELECT id, account_id, transaction_amount, transaction_type, transaction_date
+        FROM transactions_table WHERE account_id = ? AND transaction_date >= ? AND transaction_date < ?;)";
+        break;
+    case Transaction_columns::list:
+        instructions =
+        R"(SELECT id, account_id, transaction_amount, transaction_type, previous_amount, new_amount, transaction_date, transaction_name, transaction_category
+        FROM transactions_table WHERE account_id = ? AND transaction_date >= ? AND transaction_date < ?;)";
+        break;
+    case Transaction_columns::full:
+        instructions =
+        R"(SELECT id, account_id, transaction_amount, transaction_type, previous_amount, new_amount, transaction_date, transaction_name, note, transaction_category
+        FROM transactions_table WHERE account_id = ? AND transaction_date >= ? AND transaction_date < ?;)";
+        break;
+    }
+    Read_lease lease(*this);
+    sqlite3_stmt* stmt = lease.prepare(instructions);
+    if (!stmt) {
+        std::cerr << "get_monthly_information prepare failed: " << sqlite3_errmsg(lease.connection()) << std::endl;
+        return monthly_transactions;
     }
     sqlite3_bind_int(stmt, 1, account_id);
     sqlite3_bind_int(stmt, 2, start_time);
     sqlite3_bind_int(stmt, 3, end_time);
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        Transaction_info trans_info = get_transaction_info_from_stmt(stmt);
+        Transaction_info trans_info = get_transaction_info_from_stmt(stmt, columns);
         monthly_transactions.push_back(trans_info);
     }
-    sqlite3_finalize(stmt);
+    sqlite3_reset(stmt);
     return monthly_transactions;
 }
 
+//amounts are copied out of the rows a block at a time so split_amounts can run over contiguous memory
 struct specific_range_of_transactions_info Storage::get_specific_range_of_transactions_info(std::vector<Transaction_info> &range_of_transactions)
 {
-    specific_range_of_transactions_info range_of_transactions_info;
-    for (const Transaction_info &trans : range_of_transactions)
+    Amount_split split;
+    std::int32_t block[256];
+    for (size_t start = 0; start < range_of_transactions.size(); start += std::size(block))
     {
-        if (trans.transaction_amount > 0)
-        {
-            range_of_transactions_info.money_in += trans.transaction_amount;
-        }
-        else
-        {
-            range_of_transactions_info.money_out += std::abs(trans.transaction_amount);
-        }
+        size_t count = std::min(std::size(block), range_of_transactions.size() - start);
+        for (size_t i = 0; i < count; ++i)
+            block[i] = range_of_transactions[start + i].transaction_amount;
+        Amount_split block_split = split_amounts(block, count);
+        split.money_in += block_split.money_in;
+        split.money_out += block_split.money_out;
+    }
+    return range_info_from_split(split);
+}
+
+//add (sign = 1) or remove (sign = -1) one transaction from its month's rollup row.
+//must run inside the caller's write transaction so the rollup commits or rolls back with it.
+bool Storage::add_to_monthly_rollup(int account_id, std::time_t ymd, int transaction_amount, int sign)
+{
+    return upsert_monthly_rollup(account_id, year_month_from_time(ymd),
+                                 transaction_amount > 0 ? sign * transaction_amount : 0,
+                                 transaction_amount > 0 ? 0 : sign * std::abs(transaction_amount),
+                                 sign);
+}
+
+bool Storage::upsert_monthly_rollup(int account_id, int year_month, int money_in, int money_out, int txn_count)
+{
+    const char* instructions =
+    R"(INSERT INTO monthly_rollups(account_id, year_month, money_in, money_out, txn_count)
+    VALUES(?, ?, ?, ?, ?)
+    ON CONFLICT(account_id, year_month) DO UPDATE SET
+        money_in = money_in + excluded.money_in,
+        money_out = money_out + excluded.money_out,
+        txn_count = txn_count + excluded.txn_count;
+    )";
+    sqlite3_stmt* stmt = get_prepared_statement(instructions);
+    if (!stmt) {
+        std::cerr << "upsert_monthly_rollup prepare failed: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    sqlite3_bind_int(stmt, 1, account_id);
+    sqlite3_bind_int(stmt, 2, year_month);
+    sqlite3_bind_int(stmt, 3, money_in);
+    sqlite3_bind_int(stmt, 4, money_out);
+    sqlite3_bind_int(stmt, 5, txn_count);
+    int rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+    if (rc != SQLITE_DONE) {
+        std::cerr << "upsert_monthly_rollup failed: " << sqlite3_errmsg(db) << std::endl;
+        return false;
     }
-    if (range_of_transactions_info.money_in > range_of_transactions_info.money_out)
+    return true;
+}
+
+//repair monthly_rollups from the raw transaction rows (e.g. after a timezone change)
+bool Storage::rebuild_monthly_rollups()
+{
+    if (!exec_sql(db, "BEGIN IMMEDIATE;", "rebuild_monthly_rollups BEGIN"))
+        return false;
+    if (!exec_sql(db, sql_rebuild_monthly_rollups, "rebuild_monthly_rollups"))
     {
-        range_of_transactions_info.money_remaining = range_of_transactions_info.money_in - range_of_transactions_info.money_out;
+        exec_sql(db, "ROLLBACK;", "rebuild_monthly_rollups ROLLBACK");
+        return false;
     }
-    else
+    if (!exec_sql(db, "COMMIT;", "rebuild_monthly_rollups COMMIT"))
+    {
+        exec_sql(db, "ROLLBACK;", "rebuild_monthly_rollups ROLLBACK");
+        return false;
+    }
+    return true;
+}
+
+std::vector<Monthly_rollup> Storage::get_monthly_rollups(int account_id, int from_year_month, int to_year_month)
+{
+    std::vector<Monthly_rollup> rollups;
+    const char* instructions =
+    R"(SELECT year_month, money_in, money_out, txn_count FROM monthly_rollups
+    WHERE account_id = ? AND year_month >= ? AND year_month <= ? AND txn_count > 0
+    ORDER BY year_month;
+    )";
+    Read_lease lease(*this);
+    sqlite3_stmt* stmt = lease.prepare(instructions);
+    if (!stmt) {
+        std::cerr << "get_monthly_rollups prepare failed: " << sqlite3_errmsg(lease.connection()) << std::endl;
+        return rollups;
+    }
+    sqlite3_bind_int(stmt, 1, account_id);
+    sqlite3_bind_int(stmt, 2, from_year_month);
+    sqlite3_bind_int(stmt, 3, to_year_month);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        Monthly_rollup rollup;
+        rollup.account_id = account_id;
+        rollup.year_month = sqlite3_column_int(stmt, 0);
+        rollup.money_in = sqlite3_column_int(stmt, 1);
+        rollup.money_out = sqlite3_column_int(stmt, 2);
+        rollup.txn_count = sqlite3_column_int(stmt, 3);
+        rollups.push_back(rollup);
+    }
+    sqlite3_reset(stmt);
+    return rollups;
+}
+
+specific_range_of_transactions_info Storage::get_range_summary(int account_id, std::time_t start_time, std::time_t end_time)
+{
+    // once every row is cached, the running totals answer any range in O(log n); nothing to memoize
+    if (all_transactions_cached)
+        return range_info_from_split(get_transactions(account_id).totals_in_date_range(start_time, end_time));
+
+    // the account view asks for whole local months; each is kept as one entry. Other ranges are
+    // rare enough to query each time instead of growing the cache with one entry per range.
+    const int first_month = year_month_from_time(start_time);
+    const int end_month = year_month_from_time(end_time);
+    if (start_time >= end_time || time_from_year_month(first_month) != start_time || time_from_year_month(end_month) != end_time)
+        return query_range_summary(account_id, start_time, end_time);
+
+    specific_range_of_transactions_info range_info;
+    for (int year_month = first_month; year_month != end_month; year_month = next_year_month(year_month))
+    {
+        const specific_range_of_transactions_info& month = month_summary(account_id, year_month);
+        range_info.money_in += month.money_in;
+        range_info.money_out += month.money_out;
+    }
+    range_info.money_remaining = std::max<std::int64_t>(range_info.money_in - range_info.money_out, 0);
+    return range_info;
+}
+
+const specific_range_of_transactions_info& Storage::month_summary(int account_id, int year_month)
+{
+    Month_summary_key key{account_id, year_month};
+    auto it = month_summaries.find(key);
+    if (it == month_summaries.end())
     {
-        range_of_transactions_info.money_remaining = 0;
+        specific_range_of_transactions_info range_info = query_range_summary(account_id,
+            time_from_year_month(year_month), time_from_year_month(next_year_month(year_month)));
+        it = month_summaries.emplace(key, range_info).first;
+    }
+    return it->second;
+}
+
+specific_range_of_transactions_info Storage::query_range_summary(int account_id, std::time_t start_time, std::time_t end_time)
+{
+    specific_range_of_transactions_info range_info;
+    const char* instructions =
+    R"(SELECT COALESCE(SUM(CASE WHEN transaction_amount > 0 THEN transaction_amount ELSE 0 END), 0),
+              COALESCE(SUM(CASE WHEN transaction_amount > 0 THEN 0 ELSE -transaction_amount END), 0)
+    FROM transactions_table WHERE account_id = ? AND transaction_date >= ? AND transaction_date < ?;
+    )";
+    Read_lease lease(*this);
+    sqlite3_stmt* stmt = lease.prepare(instructions);
+    if (!stmt) {
+        std::cerr << "query_range_summary prepare failed: " << sqlite3_errmsg(lease.connection()) << std::endl;
+        return range_info;
     }
-    return range_of_transactions_info;
+    sqlite3_bind_int(stmt, 1, account_id);
+    sqlite3_bind_int(stmt, 2, start_time);
+    sqlite3_bind_int(stmt, 3, end_time);
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        range_info.money_in = sqlite3_column_int64(stmt, 0);
+        range_info.money_out = sqlite3_column_int64(stmt, 1);
+    }
+    sqlite3_reset(stmt);
+    range_info.money_remaining = std::max<std::int64_t>(range_info.money_in - range_info.money_out, 0);
+    return range_info;
+}
+
+//add (sign = 1) or remove (sign = -1) one transaction from its month's entry, if that month is cached
+void Storage::apply_to_month_summaries(int account_id, std::time_t ymd, int transaction_amount, int sign)
+{
+    auto it = month_summaries.find(Month_summary_key{account_id, year_month_from_time(ymd)});
+    if (it == month_summaries.end())
+        return;
+    specific_range_of_transactions_info& range_info = it->second;
+    if (transaction_amount > 0)
+        range_info.money_in += sign * transaction_amount;
+    else
+        range_info.money_out += sign * std::abs(transaction_amount);
+    range_info.money_remaining = std::max<std::int64_t>(range_info.money_in - range_info.money_out, 0);
+}
+
+//the balance as of `when` is today's balance minus every transaction dated at or after it, so a
+//back-dated row or a manual balance edit never leaves a stale stored history behind
+std::optional<std::int64_t> Storage::get_balance_at(int account_id, std::time_t when)
+{
+    if (all_transactions_cached) {
+        for (const Account_info& acc_info : accounts_vec) {
+            if (acc_info.account_id != account_id)
+                continue;
+            const Account_transactions& list = get_transactions(account_id);
+            std::int64_t since = list.net_before(std::numeric_limits<std::time_t>::max()) - list.net_before(when);
+            return acc_info.money_amount - since;
+        }
+    }
+
+    const char* instructions =
+    R"(SELECT money_amount - COALESCE((SELECT SUM(transaction_amount) FROM transactions_table
+        WHERE account_id = accounts.id AND transaction_date >= ?), 0)
+    FROM accounts WHERE id = ?;)";
+    sqlite3_stmt* stmt = get_prepared_statement(instructions);
+    if (!stmt) {
+        std::cerr << "get_balance_at prepare failed: " << sqlite3_errmsg(db) << std::endl;
+        return std::nullopt;
+    }
+    sqlite3_bind_int64(stmt, 1, when);
+    sqlite3_bind_int(stmt, 2, account_id);
+    std::optional<std::int64_t> balance;
+    if (sqlite3_step(stmt) == SQLITE_ROW)
+        balance = sqlite3_column_int64(stmt, 0);
+    sqlite3_reset(stmt);
+    return balance;
 }
 
-void Storage::modify_account_in_storage(int account_id, std::string new_account_name, Account_type new_type_of_account, int new_money,
+//without the cache, walk the account's rows newest first once (the account/date index covers the
+//amount) and rewind the balance past each requested time on the way down
+std::vector<std::int64_t> Storage::get_balances_at(int account_id, std::span<const std::time_t> times)
+{
+    std::vector<std::int64_t> balances;
+    balances.reserve(times.size());
+    if (all_transactions_cached || times.size() < 2) {
+        for (std::time_t when : times)
+            balances.push_back(get_balance_at(account_id, when).value_or(0));
+        return balances;
+    }
+
+    balances.assign(times.size(), 0);
+    std::optional<std::int64_t> current = get_balance_at(account_id, std::numeric_limits<std::time_t>::max());
+    if (!current)
+        return balances;
+
+    std::vector<size_t> newest_first(times.size());
+    for (size_t i = 0; i < times.size(); ++i)
+        newest_first[i] = i;
+    std::sort(newest_first.begin(), newest_first.end(), [&times](size_t a, size_t b) { return times[a] > times[b]; });
+
+    const char* instructions =
+    R"(SELECT transaction_date, transaction_amount FROM transactions_table
+    WHERE account_id = ? ORDER BY transaction_date DESC;)";
+    sqlite3_stmt* stmt = get_prepared_statement(instructions);
+    if (!stmt) {
+        std::cerr << "get_balances_at prepare failed: " << sqlite3_errmsg(db) << std::endl;
+        return balances;
+    }
+    sqlite3_bind_int(stmt, 1, account_id);
+    std::int64_t balance = *current;
+    bool has_row = sqlite3_step(stmt) == SQLITE_ROW;
+    for (size_t index : newest_first) {
+        while (has_row && sqlite3_column_int64(stmt, 0) >= times[index]) {
+            balance -= sqlite3_column_int64(stmt, 1);
+            has_row = sqlite3_step(stmt) == SQLITE_ROW;
+        }
+        balances[index] = balance;
+    }
+    sqlite3_reset(stmt);
+    return balances;
+}
+
+void Storage::invalidate_month_summaries(int account_id)
+{
+    std::erase_if(month_summaries, [account_id](const auto& entry) { return entry.first.account_id == account_id; });
+}
+
+size_t Storage::Month_summary_key_hash::operator()(const Month_summary_key& key) const
+{
+    size_t h = std::hash<int>{}(key.account_id);
+    h ^= std::hash<int>{}(key.year_month) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+//the change-set carries the account as re-read from its row, so columns the edit does not
+//touch (initial_money_amount) come back as stored
+std::optional<Storage_changes> Storage::modify_account_in_storage(int account_id, std::string new_account_name, Account_type new_type_of_account, int new_money,
                                         int interest_rate, int compounding_frequency, int principal, int term, int monthly_payment, 
                                         int remaining_balance, int remaining_term, int remaining_interest, int remaining_principal, 
                                         int remaining_total, int credit_limit, int minimum_payment)
 {
-    sqlite3_stmt* stmt = nullptr;
     const char* sql_account_type;
     const char* instructions = "UPDATE accounts SET account_name = ?, account_type = ?, money_amount = ?, is_asset = ?, interest_rate = ?, compounding_frequency = ?, principal = ?, term = ?, monthly_payment = ?, remaining_balance = ?, remaining_term = ?, remaining_interest = ?, remaining_principal = ?, remaining_total = ?, credit_limit = ?, minimum_payment = ? WHERE id = ?;";
-    int rc = sqlite3_prepare_v2(db, instructions, -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    sqlite3_stmt* stmt = get_prepared_statement(instructions);
+    if (!stmt) {
         std::cerr << "modify_account_in_storage prepare failed: " << sqlite3_errmsg(db) << std::endl;
-        return;
+        return std::nullopt;
     }
 
     sql_account_type = account_type_to_string(new_type_of_account);
@@ -755,51 +1872,123 @@ void Storage::modify_account_in_storage(int account_id, std::string new_account_
         sqlite3_bind_int(stmt, 16, minimum_payment);
     }
     sqlite3_bind_int(stmt, 17, account_id);
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    int rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
     if (rc != SQLITE_DONE) {
         std::cerr << "modify_account_in_storage failed: " << sqlite3_errmsg(db) << std::endl;
-        return;
+        return std::nullopt;
     }
-    // myDB.load_accounts(); will refresh the accounts_vec
-    // myDB.load_all_transactions(); will refresh the transactions_by_account map
+    if (sqlite3_changes(db) == 0)
+        return std::nullopt;
+
+    sqlite3_stmt* select_stmt = get_prepared_statement("SELECT * FROM accounts WHERE id = ?;");
+    if (!select_stmt) {
+        std::cerr << "modify_account_in_storage SELECT prepare failed: " << sqlite3_errmsg(db) << std::endl;
+        return std::nullopt;
+    }
+    sqlite3_bind_int(select_stmt, 1, account_id);
+    Storage_changes changes;
+    if (sqlite3_step(select_stmt) == SQLITE_ROW)
+        changes.accounts_saved.push_back(account_info_from_stmt(select_stmt));
+    sqlite3_reset(select_stmt);
+    if (changes.accounts_saved.empty())
+        return std::nullopt;
+
+    cache_changes(changes, Summary_update::patch);
+    return changes;
 }
 
-void Storage::delete_account(int account_id)
+//the account, its transactions and its rollups go in one transaction: a failure part way leaves
+//all three as they were instead of orphaned rows
+std::optional<Storage_changes> Storage::delete_account(int account_id)
 {
-    sqlite3_stmt* stmt = nullptr;
-    const char* instructions = "DELETE FROM accounts WHERE id = ?;";
-    int rc = sqlite3_prepare_v2(db, instructions, -1, &stmt, nullptr);
+    auto rollback_transaction = [this]() {
+        char* rollback_err = nullptr;
+        int rollback_rc = sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, &rollback_err);
+        if (rollback_rc != SQLITE_OK) {
+            std::cerr << "delete_account ROLLBACK failed: "
+                      << (rollback_err ? rollback_err : sqlite3_errmsg(db)) << std::endl;
+            sqlite3_free(rollback_err);
+        }
+    };
+
+    char* begin_err = nullptr;
+    int rc = sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, &begin_err);
     if (rc != SQLITE_OK) {
+        std::cerr << "delete_account BEGIN failed: "
+                  << (begin_err ? begin_err : sqlite3_errmsg(db)) << std::endl;
+        sqlite3_free(begin_err);
+        return std::nullopt;
+    }
+
+    const char* instructions = "DELETE FROM accounts WHERE id = ?;";
+    sqlite3_stmt* stmt = get_prepared_statement(instructions);
+    if (!stmt) {
         std::cerr << "delete_account prepare failed: " << sqlite3_errmsg(db) << std::endl;
-        return;
+        rollback_transaction();
+        return std::nullopt;
     }
     sqlite3_bind_int(stmt, 1, account_id);
     rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    sqlite3_reset(stmt);
     if (rc != SQLITE_DONE) {
         std::cerr << "delete_account failed: " << sqlite3_errmsg(db) << std::endl;
-        return;
+        rollback_transaction();
+        return std::nullopt;
     }
     
-    sqlite3_stmt* delete_transactions_stmt = nullptr;
     const char* delete_transactions_sql = "DELETE FROM transactions_table WHERE account_id = ?;";
-    rc = sqlite3_prepare_v2(db, delete_transactions_sql, -1, &delete_transactions_stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    sqlite3_stmt* delete_transactions_stmt = get_prepared_statement(delete_transactions_sql);
+    if (!delete_transactions_stmt) {
         std::cerr << "delete_account delete_transactions prepare failed: " << sqlite3_errmsg(db) << std::endl;
-        return;
+        rollback_transaction();
+        return std::nullopt;
     }
     sqlite3_bind_int(delete_transactions_stmt, 1, account_id);
     rc = sqlite3_step(delete_transactions_stmt);
-    sqlite3_finalize(delete_transactions_stmt);
+    sqlite3_reset(delete_transactions_stmt);
     if (rc != SQLITE_DONE) {
         std::cerr << "delete_account delete_transactions failed: " << sqlite3_errmsg(db) << std::endl;
-        return;
+        rollback_transaction();
+        return std::nullopt;
+    }
+
+    sqlite3_stmt* delete_rollups_stmt = get_prepared_statement("DELETE FROM monthly_rollups WHERE account_id = ?;");
+    if (!delete_rollups_stmt) {
+        std::cerr << "delete_account delete_rollups prepare failed: " << sqlite3_errmsg(db) << std::endl;
+        rollback_transaction();
+        return std::nullopt;
+    }
+    sqlite3_bind_int(delete_rollups_stmt, 1, account_id);
+    rc = sqlite3_step(delete_rollups_stmt);
+    sqlite3_reset(delete_rollups_stmt);
+    if (rc != SQLITE_DONE) {
+        std::cerr << "delete_account delete_rollups failed: " << sqlite3_errmsg(db) << std::endl;
+        rollback_transaction();
+        return std::nullopt;
     }
-    // myDB.load_accounts(); will refresh the accounts_vec
-    // myDB.load_all_transactions(); will refresh the transactions_by_account map
+
+    char* commit_err = nullptr;
+    rc = sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &commit_err);
+    if (rc != SQLITE_OK) {
+        std::cerr << "delete_account COMMIT failed: "
+                  << (commit_err ? commit_err : sqlite3_errmsg(db)) << std::endl;
+        sqlite3_free(commit_err);
+        rollback_transaction();
+        return std::nullopt;
+    }
+
+    Storage_changes changes;
+    changes.accounts_deleted.push_back(account_id);
+    cache_changes(changes, Summary_update::patch);
+    return changes;
 }
-Transaction_info Storage::get_transaction_info_from_stmt(sqlite3_stmt* stmt)
+
+//decode one row. Column positions depend on the projection:
+//  full:    id, account_id, amount, type, previous, new, date, name, note, category (the table's own order, so SELECT * works)
+//  list:    id, account_id, amount, type, previous, new, date, name, category
+//  summary: id, account_id, amount, type, date
+Transaction_info Storage::get_transaction_info_from_stmt(sqlite3_stmt* stmt, Transaction_columns columns)
 {
     Transaction_info trans_info;
     trans_info.transaction_id = sqlite3_column_int(stmt, 0);
@@ -807,17 +1996,15 @@ Transaction_info Storage::get_transaction_info_from_stmt(sqlite3_stmt* stmt)
     trans_info.transaction_amount = sqlite3_column_int(stmt, 2);
     trans_info.type_of_transaction = transaction_type_from_string(
         reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)));
-
     trans_info.transaction_category_need = Transaction_category_need::Other;
     trans_info.transaction_category_want = Transaction_category_want::Other;
-    if (sqlite3_column_count(stmt) >= 10) {
-        const char* cat_text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 9));
-        if (cat_text) {
-            if (trans_info.type_of_transaction == Transaction_type::Need)
-                trans_info.transaction_category_need = transaction_category_need_from_string(cat_text);
-            else if (trans_info.type_of_transaction == Transaction_type::Want)
-                trans_info.transaction_category_want = transaction_category_want_from_string(cat_text);
-        }
+
+    if (columns == Transaction_columns::summary) {
+        trans_info.account_previous_amount = 0;
+        trans_info.account_new_amount = 0;
+        trans_info.ymd = static_cast<std::time_t>(sqlite3_column_int(stmt, 4));
+        trans_info.note_loaded = false;
+        return trans_info;
     }
 
     trans_info.account_previous_amount = sqlite3_column_int(stmt, 4);
@@ -826,8 +2013,49 @@ Transaction_info Storage::get_transaction_info_from_stmt(sqlite3_stmt* stmt)
 
     const char* name_p = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 7));
     trans_info.transaction_name = name_p ? name_p : "";
-    const char* note_p = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 8));
-    trans_info.note = note_p ? note_p : "";
+
+    int category_column = 9;
+    if (columns == Transaction_columns::full) {
+        const char* note_p = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 8));
+        trans_info.note = note_p ? note_p : "";
+    } else {
+        trans_info.note_loaded = false;
+        category_column = 8;
+    }
+
+    if (sqlite3_column_count(stmt) > category_column) {
+        decode_category(trans_info.type_of_transaction, sqlite3_column_text(stmt, category_column),
+            trans_info.transaction_category_need, trans_info.transaction_category_want);
+    }
 
     return trans_info;
-}
\ No newline at end of file
+}
+
+//decode a list-projection row straight into the cache's row view. Name and note are views into
+//SQLite's buffers and only live until the next step, which is all Account_transactions::push_back
+//needs: it interns them, so loading allocates per distinct name rather than per row.
+Transaction_row Storage::get_transaction_row_from_stmt(sqlite3_stmt* stmt)
+{
+    Transaction_type type = transaction_type_from_string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)));
+    Transaction_category_need need = Transaction_category_need::Other;
+    Transaction_category_want want = Transaction_category_want::Other;
+    decode_category(type, sqlite3_column_text(stmt, 8), need, want);
+
+    const char* name_p = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 7));
+    std::string_view name = name_p ? std::string_view(name_p, sqlite3_column_bytes(stmt, 7)) : std::string_view();
+
+    return Transaction_row{
+        sqlite3_column_int(stmt, 0),
+        sqlite3_column_int(stmt, 1),
+        sqlite3_column_int(stmt, 2),
+        type,
+        need,
+        want,
+        sqlite3_column_int(stmt, 4),
+        sqlite3_column_int(stmt, 5),
+        static_cast<std::time_t>(sqlite3_column_int(stmt, 6)),
+        name,
+        std::string_view(),
+        false,
+    };
+}
@@ -1,6 +1,18 @@
 #pragma once
 #include "core_logic.h"
+#include "small_vector.h"
+#include "transaction_store.h"
+#include <condition_variable>
+#include <ctime>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 extern "C"{
     #include "../external/sqlite/sqlite3.h"
@@ -29,43 +41,275 @@ struct Account_info
     int minimum_payment;
 };
 
-struct specific_range_of_transactions_info
+// usage counters for one cached prepared statement (see Storage::get_prepared_statement)
+struct Statement_stats
+{
+    std::string sql;
+    int prepare_count = 0;   // times sqlite3_prepare ran for this SQL (1 unless it failed and was retried)
+    int hit_count = 0;       // times the already-prepared statement was reused
+};
+
+// one row of the monthly_rollups table; year_month is YYYYMM in local time
+struct Monthly_rollup
 {
+    int account_id = 0;
+    int year_month = 0;
     int money_in = 0;
-    int money_out = 0;
-    int money_remaining = 0;
+    int money_out = 0;     // positive total of outflows
+    int txn_count = 0;
+};
+
+enum class Journal_mode { rollback, wal };
+enum class Synchronous_mode { off = 0, normal = 1, full = 2, extra = 3 };
+enum class Temp_store { file = 1, memory = 2 };
+
+// connection pragmas applied when Storage opens the database; anything left unset keeps SQLite's default
+struct Storage_options
+{
+    std::optional<Journal_mode> journal_mode;
+    std::optional<Synchronous_mode> synchronous;
+    std::optional<int> cache_size;          // PRAGMA cache_size: pages if positive, KiB if negative
+    std::optional<long long> mmap_size;     // bytes of the file to memory-map, 0 disables
+    std::optional<Temp_store> temp_store;
+    int busy_timeout_ms = 0;                // how long a write waits on another connection's lock
+    int read_connections = 0;               // read-only connections for the thread-safe queries (WAL file databases only)
+    bool cache_writes = true;               // mirror committed writes into the in-memory cache; off for a connection that only writes
+
+    // rollback journal with synchronous=EXTRA: every commit is on disk, directory entry included
+    static Storage_options max_durability();
+    // WAL with synchronous=NORMAL: commits skip the fsync (the last few may roll back after a
+    // power cut, the file never corrupts), plus a larger cache, mmap reads and in-memory temp tables
+    static Storage_options fast_interactive();
+};
+
+// what the connection is actually running with, read back from the pragmas after opening
+// (e.g. journal_mode stays "memory" for ":memory:" databases even when WAL was asked for)
+struct Storage_settings
+{
+    std::string journal_mode;
+    int synchronous = 0;
+    int cache_size = 0;
+    long long mmap_size = 0;
+    int temp_store = 0;
+    int busy_timeout_ms = 0;
+    int read_connections = 0;   // size of the read-only pool that was actually opened
+};
+
+// totals are 64-bit: a range can hold many amounts that each fit an int while their sum does not
+struct specific_range_of_transactions_info
+{
+    std::int64_t money_in = 0;
+    std::int64_t money_out = 0;
+    std::int64_t money_remaining = 0;
+};
+
+// which columns a transaction query reads and decodes into Transaction_info
+enum class Transaction_columns
+{
+    summary,   // id, account_id, amount, type and date; name and note are left empty, categories Other
+    list,      // everything except the note (note_loaded = false)
+    full,
+};
+
+// what one committed write changed. The writing Storage has already applied it to its own
+// cache (unless Storage_options::cache_writes is off); callers patch their copies from it (the
+// wallet, or another connection's cache through Storage::apply_changes) instead of re-reading the
+// accounts table. Single-row writes fit the inline capacity, so building and returning one does not allocate.
+struct Storage_changes
+{
+    struct Balance
+    {
+        int account_id;
+        int money_amount;
+    };
+
+    struct Removed_transaction
+    {
+        int account_id;
+        int transaction_id;
+        int transaction_amount;
+        std::time_t ymd;
+    };
+
+    Small_vector<Balance, 2> balances;               // new balance of every account the write touched
+    Small_vector<Transaction_info, 2> inserted;      // committed rows, ids and running balances filled in
+    Small_vector<Removed_transaction, 1> removed;
+    Small_vector<Account_info, 1> accounts_saved;    // created or edited accounts, as now stored
+    Small_vector<int, 1> accounts_deleted;           // their transactions went with them
+
+    std::optional<int> balance_of(int account_id) const;
 };
 
 class Storage
 { 
     public:
         //constructors
-        explicit Storage(const std::string& db_path = "mydata.db");
+        explicit Storage(const std::string& db_path = "mydata.db", const Storage_options& options = {});
         ~Storage();
 
+        Storage(const Storage&) = delete;
+        Storage& operator=(const Storage&) = delete;
+
         //methods
-        void save_account_info(Account &acc);
-        void save_transaction_info(int account_id, Transaction_info &trans);
-        void load_transactions(int account_id);   // refresh one account's list in cache
-        void load_all_transactions();             // load all transactions at startup
-        void delete_transaction(int transaction_id, int account_id);
-        std::vector<Transaction_info> get_monthly_information(int account_id, std::time_t start_time, std::time_t end_time);
-        void modify_account_in_storage(int account_id, std::string new_account_name, Account_type new_type_of_account, int new_money,
+        // writes return what they changed, or nullopt if nothing was committed
+        std::optional<Storage_changes> save_account_info(Account &acc);
+        // transaction_amount is added to the stored balance, and account_previous_amount/
+        // account_new_amount are overwritten with the balances that commit moved between.
+        // The lvalue form fills in trans's id and the change-set carries a copy; the rvalue form
+        // moves trans into the change-set, so its strings are never copied on the way through
+        std::optional<Storage_changes> save_transaction_info(int account_id, Transaction_info &trans);
+        std::optional<Storage_changes> save_transaction_info(int account_id, Transaction_info &&trans);
+        void load_transactions(int account_id);   // refresh one account's list in cache (without notes)
+        void load_all_transactions();             // load all transactions at startup (without notes)
+        std::optional<Storage_changes> delete_transaction(int transaction_id, int account_id);
+        std::optional<Storage_changes> modify_account_in_storage(int account_id, std::string new_account_name, Account_type new_type_of_account, int new_money,
             int interest_rate, int compounding_frequency, int principal, int term, int monthly_payment, 
             int remaining_balance, int remaining_term, int remaining_interest, int remaining_principal, 
             int remaining_total, int credit_limit, int minimum_payment);
-        Transaction_info get_transaction_info_from_stmt(sqlite3_stmt* stmt);
-        void delete_account(int account_id);
-        void save_internal_transfer(int account_id_from, int account_id_to, Transaction_info &trans);
+        Transaction_info get_transaction_info_from_stmt(sqlite3_stmt* stmt, Transaction_columns columns = Transaction_columns::full);
+        std::optional<Storage_changes> delete_account(int account_id);
+        // trans is the template for both rows; pass it as an rvalue and the second row takes its strings
+        std::optional<Storage_changes> save_internal_transfer(int account_id_from, int account_id_to, Transaction_info trans);
+        std::optional<Storage_changes> save_transactions_batch(int account_id, std::span<Transaction_info> transactions);
         
+        // make room for count cached rows of this account, e.g. before an import
+        void reserve_transactions(int account_id, size_t count);
+
         std::vector<Account_info> load_accounts();
-        const std::vector<Transaction_info>& get_transactions(int account_id);
+        const Account_transactions& get_transactions(int account_id);
+        // cached rows dated in [start_time, end_time), oldest first, found by binary search on the date index
+        Account_transactions::Date_range get_transactions_in_range(int account_id, std::time_t start_time, std::time_t end_time);
+        // the note of a cached row, read from the database the first time it is asked for
+        std::string_view get_transaction_note(int account_id, int transaction_id);
         specific_range_of_transactions_info get_specific_range_of_transactions_info(std::vector<Transaction_info> &range_of_transactions);
+        // money in/out for [start_time, end_time); after load_all_transactions it comes from the cached
+        // rows' running totals in O(log n). Before that, a range of whole local calendar months (what
+        // the account view asks for) adds up per-month entries that writes keep up to date; any other
+        // range is queried each time.
+        specific_range_of_transactions_info get_range_summary(int account_id, std::time_t start_time, std::time_t end_time);
+        bool rebuild_monthly_rollups();
+        // balance with every transaction dated before `when` applied (an amount owed, for liabilities);
+        // from the cached rows once load_all_transactions has run, from SQL before that. nullopt for
+        // an unknown account; get_balances_at reports those as 0.
+        std::optional<std::int64_t> get_balance_at(int account_id, std::time_t when);
+        std::vector<std::int64_t> get_balances_at(int account_id, std::span<const std::time_t> times);
+
+        // Thread-safe reads. Everything else on Storage belongs to the thread that owns it (the UI
+        // thread). These three touch no cache and, when Storage_options::read_connections opened a
+        // pool, each call leases its own read-only WAL connection, so any number of threads can run
+        // them at once without waiting on, or blocking, a writer; they see the last committed data.
+        // Without a pool (":memory:", rollback journal) they fall back to the main connection and
+        // must be called from the owning thread like the rest.
+        std::vector<Transaction_info> get_monthly_information(int account_id, std::time_t start_time, std::time_t end_time,
+            Transaction_columns columns = Transaction_columns::list);
+        // rollup rows for from_year_month..to_year_month inclusive (YYYYMM), oldest first
+        std::vector<Monthly_rollup> get_monthly_rollups(int account_id, int from_year_month, int to_year_month);
+        // uncached money in/out for [start_time, end_time); get_range_summary fills a missing month with it
+        specific_range_of_transactions_info query_range_summary(int account_id, std::time_t start_time, std::time_t end_time);
+
+        // keep this cache in step with a write committed by another connection (see Write_pipeline).
+        // The month summaries it touches are dropped and re-read rather than patched.
+        void apply_changes(const Storage_changes& changes);
 
         bool empty();
 
+        std::vector<Statement_stats> get_statement_stats() const;
+
+        // called after each statement finishes, with its SQL and run time (sqlite3_trace_v2 profile
+        // events), for statements run on the thread that set the observer: the main connection and
+        // any pooled reader it leases. Queries other threads run are not reported. nullptr turns
+        // tracing off. Waits for every pooled reader to be idle while it installs the trace.
+        using Statement_observer = void (*)(void* context, const char* sql, double milliseconds);
+        void set_statement_observer(Statement_observer observer, void* context);
+
+        // PRAGMA user_version of the open database; the constructor migrates it up to latest_schema_version()
+        int schema_version();
+        static int latest_schema_version();
+
+        Storage_settings effective_settings();
+
     private:
+        struct Prepared_statement
+        {
+            sqlite3_stmt* stmt = nullptr;
+            int prepare_count = 0;
+            int hit_count = 0;
+        };
+
+        // one pooled read-only connection with its own statement cache
+        struct Read_connection
+        {
+            sqlite3* db = nullptr;
+            std::unordered_map<std::string_view, sqlite3_stmt*> statements;
+        };
+
+        // borrows a pooled reader for one query (waiting if all are busy), or the main connection
+        // when there is no pool; prepare() follows the same string-literal rule as get_prepared_statement
+        class Read_lease
+        {
+            public:
+                explicit Read_lease(Storage& storage);
+                ~Read_lease();
+                Read_lease(const Read_lease&) = delete;
+                Read_lease& operator=(const Read_lease&) = delete;
+
+                sqlite3_stmt* prepare(const char* sql);
+                sqlite3* connection() const;
+
+            private:
+                Storage& storage;
+                Read_connection* reader = nullptr;
+        };
+
+        struct Month_summary_key
+        {
+            int account_id;
+            int year_month;   // YYYYMM, local time
+            bool operator==(const Month_summary_key& other) const = default;
+        };
+
+        struct Month_summary_key_hash
+        {
+            size_t operator()(const Month_summary_key& key) const;
+        };
+
+        // sql must be a string literal (or otherwise outlive the Storage): it is used as the cache key
+        sqlite3_stmt* get_prepared_statement(const char* sql);
+        Transaction_row get_transaction_row_from_stmt(sqlite3_stmt* stmt);   // list projection only
+        void apply_options(const Storage_options& options);
+        void open_read_connections(const std::string& db_path, const Storage_options& options);
+        void run_migrations();
+
+        bool insert_transaction(int account_id, Transaction_info& trans);   // commit one row; fills in its id and balances
+        bool add_to_monthly_rollup(int account_id, std::time_t ymd, int transaction_amount, int sign);
+        bool upsert_monthly_rollup(int account_id, int year_month, int money_in, int money_out, int txn_count);
+        // a write this Storage committed patches the month summaries; one from another connection
+        // drops them, since a summary read since that commit may already include it
+        enum class Summary_update { patch, drop };
+        void cache_changes(const Storage_changes& changes, Summary_update summaries);
+
+        const specific_range_of_transactions_info& month_summary(int account_id, int year_month);
+        void apply_to_month_summaries(int account_id, std::time_t ymd, int transaction_amount, int sign);
+        void invalidate_month_summaries(int account_id);
+        void set_cached_balance(int account_id, int money_amount);
+
+        static int trace_statement(unsigned event, void* storage, void* stmt, void* nanoseconds);
+
         sqlite3 *db = nullptr;
+        Statement_observer statement_observer = nullptr;
+        void* statement_observer_context = nullptr;
+        std::thread::id statement_observer_thread;
+        std::unordered_map<std::string_view, Prepared_statement> prepared_statements;
         std::vector<Account_info> accounts_vec;
-        std::map<int, std::vector<Transaction_info>> transactions_by_account;
+        std::map<int, Account_transactions> transactions_by_account;
+        bool all_transactions_cached = false;   // set by load_all_transactions: the cache holds every row
+        bool cache_writes = true;               // Storage_options::cache_writes
+        // money in/out per account and calendar month, filled as months are asked for; at most one
+        // entry per month an account has shown, and a write touches only its own month's entry
+        std::unordered_map<Month_summary_key, specific_range_of_transactions_info, Month_summary_key_hash> month_summaries;
+
+        std::vector<std::unique_ptr<Read_connection>> read_connections;
+        std::vector<Read_connection*> idle_readers;
+        std::mutex read_pool_mutex;
+        std::condition_variable reader_released;
 };
\ No newline at end of file
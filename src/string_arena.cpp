@@ -0,0 +1,64 @@
+#include "string_arena.h"
+#include <cstring>
+
+String_arena::String_arena()
+{
+    strings.push_back(std::string_view("", 0));
+}
+
+String_arena::Handle String_arena::intern(std::string_view text)
+{
+    if (text.empty())
+        return 0;
+    auto it = handles.find(text);
+    if (it != handles.end())
+        return it->second;
+
+    char* copy = allocate(text.size() + 1);
+    std::memcpy(copy, text.data(), text.size());
+    copy[text.size()] = '\0';
+
+    std::string_view stored(copy, text.size());
+    Handle handle = static_cast<Handle>(strings.size());
+    strings.push_back(stored);
+    handles.emplace(stored, handle);
+    return handle;
+}
+
+//bump-allocate from the current block; strings bigger than a block get a block of their own
+char* String_arena::allocate(size_t bytes)
+{
+    if (blocks.empty() || block_used + bytes > block_sizes.back())
+    {
+        size_t size = bytes > block_size ? bytes : block_size;
+        blocks.push_back(std::make_unique<char[]>(size));
+        block_sizes.push_back(size);
+        block_used = 0;
+    }
+    char* out = blocks.back().get() + block_used;
+    block_used += bytes;
+    return out;
+}
+
+void String_arena::clear()
+{
+    handles.clear();
+    strings.clear();
+    strings.push_back(std::string_view("", 0));
+    blocks.clear();
+    block_sizes.clear();
+    block_used = 0;
+}
+
+size_t String_arena::memory_bytes() const
+{
+    size_t bytes = strings.capacity() * sizeof(std::string_view)
+        + block_sizes.capacity() * sizeof(size_t)
+        + blocks.capacity() * sizeof(std::unique_ptr<char[]>);
+    for (size_t size : block_sizes)
+        bytes += size;
+    // rough cost of one hash node plus its bucket slot
+    bytes += handles.size() * (sizeof(std::string_view) + sizeof(Handle) + 2 * sizeof(void*))
+        + handles.bucket_count() * sizeof(void*);
+    return bytes;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Interning arena for transaction names and notes. Each distinct string is copied once into large
+// blocks and identified by a 32-bit handle; handle 0 is always the empty string. Views returned by
+// view() stay valid (and NUL-terminated, so data() can go straight to printf/ImGui) until clear(),
+// which releases every block at once.
+class String_arena
+{
+    public:
+        using Handle = std::uint32_t;
+
+        String_arena();
+        String_arena(String_arena&&) noexcept = default;
+        String_arena& operator=(String_arena&&) noexcept = default;
+
+        Handle intern(std::string_view text);
+        std::string_view view(Handle handle) const { return strings[handle]; }
+
+        size_t string_count() const { return strings.size(); }
+        void clear();
+
+        // heap bytes held by the blocks and the intern table
+        size_t memory_bytes() const;
+
+    private:
+        static constexpr size_t block_size = 64 * 1024;
+
+        char* allocate(size_t bytes);
+
+        std::vector<std::unique_ptr<char[]>> blocks;
+        std::vector<size_t> block_sizes;
+        size_t block_used = 0;   // bytes used in blocks.back()
+
+        std::vector<std::string_view> strings;
+        std::unordered_map<std::string_view, Handle> handles;
+};
@@ -0,0 +1,120 @@
+#include "transaction_display.h"
+#include "helpers.h"
+#include <clocale>
+#include <cstdio>
+#include <ctime>
+
+namespace
+{
+    //exact cents, unlike going through float dollars
+    void format_amount(char (&buf)[16], int cents)
+    {
+        long long value = cents;
+        const char* sign = value >= 0 ? "+" : "-";
+        if (value < 0)
+            value = -value;
+        std::snprintf(buf, sizeof(buf), "%s%lld.%02lld", sign, value / 100, value % 100);
+    }
+
+    long utc_offset_at(std::time_t when)
+    {
+        const std::tm local = *std::localtime(&when);
+        const std::tm utc = *std::gmtime(&when);
+        const long days = local.tm_yday - utc.tm_yday;   // the instants used are mid-month, no year wrap
+        return days * 86400 + (local.tm_hour - utc.tm_hour) * 3600L + (local.tm_min - utc.tm_min) * 60L;
+    }
+}
+
+Display_settings current_display_settings()
+{
+    Display_settings settings;
+    const char* locale = std::setlocale(LC_TIME, nullptr);
+    settings.time_locale = locale ? locale : "";
+    settings.utc_offsets[0] = utc_offset_at(1610712000);   // 2021-01-15 12:00 UTC
+    settings.utc_offsets[1] = utc_offset_at(1626350400);   // 2021-07-15 12:00 UTC
+    return settings;
+}
+
+Transaction_display_cache::Transaction_display_cache() : settings(current_display_settings()) {}
+
+std::span<const Transaction_text> Transaction_display_cache::text(int account_id, const Account_transactions& rows)
+{
+    Account_text& cache = accounts[account_id];
+    if (cache.rows == &rows && cache.revision == rows.revision() && cache.generation == generation)
+        return cache.text;
+
+    size_t kept = 0;
+    if (cache.rows == &rows && cache.generation == generation)
+    {
+        // sequences only grow and, unlike ids, are never reused, so the rows still present are an
+        // ordered subsequence of the cached ones and the rows after them are new
+        const std::vector<std::uint64_t>& sequences = rows.row_sequences();
+        for (size_t i = 0; i < cache.sequences.size() && kept < sequences.size(); ++i)
+        {
+            if (cache.sequences[i] != sequences[kept])
+                continue;
+            cache.sequences[kept] = cache.sequences[i];
+            cache.text[kept] = cache.text[i];
+            ++kept;
+        }
+    }
+    cache.rows = &rows;
+    cache.revision = rows.revision();
+    cache.generation = generation;
+    format_from(cache, rows, kept);
+    return cache.text;
+}
+
+//format rows[first..] into the cache, which keeps its first `first` entries
+void Transaction_display_cache::format_from(Account_text& cache, const Account_transactions& rows, size_t first)
+{
+    cache.sequences.resize(rows.size());
+    cache.text.resize(rows.size());
+    const std::vector<std::uint64_t>& sequences = rows.row_sequences();
+    const std::vector<int>& amounts = rows.amounts();
+    const std::vector<std::time_t>& dates = rows.dates();
+    const std::vector<std::uint8_t>& types = rows.types();
+    const std::vector<std::uint8_t>& categories = rows.categories();
+    // rows often share a minute (imports are usually dated by day), so localtime runs once per minute seen
+    std::time_t last_minute = -1;
+    const char* last_date = nullptr;
+    for (size_t row = first; row < rows.size(); ++row)
+    {
+        Transaction_text& text = cache.text[row];
+        cache.sequences[row] = sequences[row];
+        format_amount(text.amount, amounts[row]);
+        const Transaction_type type = static_cast<Transaction_type>(types[row]);
+        text.type = transaction_type_to_string(type);
+        if (type == Transaction_type::Need)
+            text.category = transaction_category_need_to_string(static_cast<Transaction_category_need>(categories[row]));
+        else if (type == Transaction_type::Want)
+            text.category = transaction_category_want_to_string(static_cast<Transaction_category_want>(categories[row]));
+        else
+            text.category = "";
+        const std::time_t minute = dates[row] / 60;
+        if (last_date && minute == last_minute)
+            std::snprintf(text.date, sizeof(text.date), "%s", last_date);
+        else
+        {
+            std::strftime(text.date, sizeof(text.date), "%Y-%m-%d %H:%M", std::localtime(&dates[row]));
+            last_minute = minute;
+            last_date = text.date;
+        }
+    }
+    formatted_count += static_cast<long long>(rows.size() - first);
+}
+
+bool Transaction_display_cache::refresh_settings()
+{
+    Display_settings now = current_display_settings();
+    if (now == settings)
+        return false;
+    settings = std::move(now);
+    invalidate();
+    return true;
+}
+
+void Transaction_display_cache::invalidate()
+{
+    generation++;
+}
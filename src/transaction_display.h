@@ -0,0 +1,66 @@
+#pragma once
+#include "transaction_store.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Display text of one transaction row, formatted once instead of on every frame
+struct Transaction_text
+{
+    char amount[16];        // "+21474836.47" at most, exact cents
+    char date[20];          // "%Y-%m-%d %H:%M" in local time
+    const char* type;       // static label from transaction_type_to_string
+    const char* category;   // need or want category label, "" for other types
+};
+
+// the settings the cached text depends on; a change to either means every row has to be reformatted
+struct Display_settings
+{
+    std::string time_locale;   // setlocale(LC_TIME) name
+    long utc_offsets[2];       // local offset at two fixed instants (winter and summer), so DST
+                               // turning over does not count but a different timezone does
+
+    bool operator==(const Display_settings& other) const = default;
+};
+
+Display_settings current_display_settings();
+
+// Formatted text for every cached transaction, kept next to the Account_transactions it mirrors.
+// Text is index-aligned with the store (text[i] belongs to rows[i]). When a store changes, only
+// the rows it gained are formatted; kept rows are matched by Account_transactions::row_sequences()
+// (an id can come back on a different row) and erased ones dropped, so each row is formatted once
+// after it is loaded or inserted. Everything is reformatted only when the display settings change.
+class Transaction_display_cache
+{
+    public:
+        Transaction_display_cache();
+
+        // the text of every row of `rows` (account_id's cached transactions), brought up to date first.
+        // Valid until the next call for the same account.
+        std::span<const Transaction_text> text(int account_id, const Account_transactions& rows);
+
+        // re-read the locale and timezone; returns true (and drops every formatted row) if they changed
+        bool refresh_settings();
+        void invalidate();
+
+        long long rows_formatted() const { return formatted_count; }
+
+    private:
+        struct Account_text
+        {
+            const Account_transactions* rows = nullptr;
+            std::uint64_t revision = 0;
+            std::uint64_t generation = 0;
+            std::vector<std::uint64_t> sequences;   // row sequence of each text entry, to match rows across changes
+            std::vector<Transaction_text> text;
+        };
+
+        void format_from(Account_text& cache, const Account_transactions& rows, size_t first);
+
+        std::unordered_map<int, Account_text> accounts;
+        Display_settings settings;
+        std::uint64_t generation = 1;   // bumped by invalidate()
+        long long formatted_count = 0;
+};
@@ -0,0 +1,317 @@
+#include "transaction_store.h"
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+    std::uint64_t next_revision()
+    {
+        static std::atomic<std::uint64_t> last{0};
+        return ++last;
+    }
+}
+
+Transaction_info Transaction_row::to_info() const
+{
+    Transaction_info trans;
+    trans.transaction_id = transaction_id;
+    trans.account_id = account_id;
+    trans.transaction_amount = transaction_amount;
+    trans.type_of_transaction = type_of_transaction;
+    trans.transaction_category_need = transaction_category_need;
+    trans.transaction_category_want = transaction_category_want;
+    trans.account_previous_amount = account_previous_amount;
+    trans.account_new_amount = account_new_amount;
+    trans.ymd = ymd;
+    trans.transaction_name = std::string(transaction_name);
+    trans.note = std::string(note);
+    trans.note_loaded = note_loaded;
+    return trans;
+}
+
+Transaction_row Account_transactions::operator[](size_t index) const
+{
+    const Transaction_type type = static_cast<Transaction_type>(type_codes[index]);
+    Transaction_category_need need = Transaction_category_need::Other;
+    Transaction_category_want want = Transaction_category_want::Other;
+    if (type == Transaction_type::Need)
+        need = static_cast<Transaction_category_need>(category_codes[index]);
+    else if (type == Transaction_type::Want)
+        want = static_cast<Transaction_category_want>(category_codes[index]);
+
+    return Transaction_row{
+        ids[index],
+        account_id,
+        amount_column[index],
+        type,
+        need,
+        want,
+        previous_amounts[index],
+        new_amounts[index],
+        date_column[index],
+        strings.view(names[index]),
+        strings.view(notes[index]),
+        notes_loaded[index] != 0,
+    };
+}
+
+size_t Account_transactions::find(int transaction_id) const
+{
+    auto it = std::lower_bound(ids.begin(), ids.end(), transaction_id);
+    if (it == ids.end() || *it != transaction_id)
+        return size();
+    return static_cast<size_t>(it - ids.begin());
+}
+
+Account_transactions::Date_range Account_transactions::in_date_range(std::time_t start, std::time_t end) const
+{
+    auto first = std::lower_bound(sorted_dates.begin(), sorted_dates.end(), start);
+    auto last = std::lower_bound(first, sorted_dates.end(), std::max(start, end));
+    size_t first_pos = static_cast<size_t>(first - sorted_dates.begin());
+    size_t last_pos = static_cast<size_t>(last - sorted_dates.begin());
+    return Date_range{
+        const_iterator(this, first_pos, date_order.data()),
+        const_iterator(this, last_pos, date_order.data()),
+        std::span<const std::time_t>(sorted_dates.data() + first_pos, last_pos - first_pos),
+        std::span<const int>(sorted_amounts.data() + first_pos, last_pos - first_pos),
+    };
+}
+
+Amount_split Account_transactions::totals_before(size_t pos) const
+{
+    if (pos == 0)
+        return Amount_split{};
+    return Amount_split{running_in[pos - 1], running_out[pos - 1]};
+}
+
+Amount_split Account_transactions::totals_in_date_range(std::time_t start, std::time_t end) const
+{
+    auto first = std::lower_bound(sorted_dates.begin(), sorted_dates.end(), start);
+    auto last = std::lower_bound(first, sorted_dates.end(), std::max(start, end));
+    Amount_split before_first = totals_before(static_cast<size_t>(first - sorted_dates.begin()));
+    Amount_split before_last = totals_before(static_cast<size_t>(last - sorted_dates.begin()));
+    return Amount_split{before_last.money_in - before_first.money_in, before_last.money_out - before_first.money_out};
+}
+
+std::int64_t Account_transactions::net_before(std::time_t when) const
+{
+    Amount_split totals = totals_before(static_cast<size_t>(std::lower_bound(sorted_dates.begin(), sorted_dates.end(), when) - sorted_dates.begin()));
+    return totals.money_in - totals.money_out;
+}
+
+void Account_transactions::push_back(const Transaction_info& trans)
+{
+    push_back(Transaction_row{
+        trans.transaction_id,
+        trans.account_id,
+        trans.transaction_amount,
+        trans.type_of_transaction,
+        trans.transaction_category_need,
+        trans.transaction_category_want,
+        trans.account_previous_amount,
+        trans.account_new_amount,
+        trans.ymd,
+        trans.transaction_name,
+        trans.note,
+        trans.note_loaded,
+    });
+}
+
+void Account_transactions::push_back(const Transaction_row& row)
+{
+    append(row);
+    index_dates();
+}
+
+void Account_transactions::append(const Transaction_row& row)
+{
+    std::uint8_t category = 0;
+    if (row.type_of_transaction == Transaction_type::Need)
+        category = static_cast<std::uint8_t>(row.transaction_category_need);
+    else if (row.type_of_transaction == Transaction_type::Want)
+        category = static_cast<std::uint8_t>(row.transaction_category_want);
+
+    account_id = row.account_id;
+    revision_number = next_revision();
+    ids.push_back(row.transaction_id);
+    sequences.push_back(revision_number);
+    amount_column.push_back(row.transaction_amount);
+    date_column.push_back(row.ymd);
+    type_codes.push_back(static_cast<std::uint8_t>(row.type_of_transaction));
+    category_codes.push_back(category);
+    previous_amounts.push_back(row.account_previous_amount);
+    new_amounts.push_back(row.account_new_amount);
+    notes_loaded.push_back(row.note_loaded ? 1 : 0);
+    names.push_back(strings.intern(row.transaction_name));
+    notes.push_back(strings.intern(row.note));
+}
+
+void Account_transactions::index_dates()
+{
+    const size_t indexed = date_order.size();
+    if (indexed == size())
+        return;
+
+    // one new row (a single insert): it has the highest id, so it goes after every row on its date
+    if (indexed + 1 == size())
+    {
+        std::time_t date = date_column[indexed];
+        size_t pos = static_cast<size_t>(std::upper_bound(sorted_dates.begin(), sorted_dates.end(), date) - sorted_dates.begin());
+        const int amount = amount_column[indexed];
+        date_order.insert(date_order.begin() + pos, static_cast<std::uint32_t>(indexed));
+        sorted_dates.insert(sorted_dates.begin() + pos, date);
+        sorted_amounts.insert(sorted_amounts.begin() + pos, amount);
+
+        // a back-dated row also moves every later running total by its amount
+        const std::int64_t in = amount > 0 ? amount : 0;
+        const std::int64_t out = amount > 0 ? 0 : -static_cast<std::int64_t>(amount);
+        Amount_split before = totals_before(pos);
+        running_in.insert(running_in.begin() + pos, before.money_in + in);
+        running_out.insert(running_out.begin() + pos, before.money_out + out);
+        for (size_t later = pos + 1; later < running_in.size(); ++later)
+        {
+            running_in[later] += in;
+            running_out[later] += out;
+        }
+        return;
+    }
+
+    auto by_date = [this](std::uint32_t a, std::uint32_t b) {
+        return date_column[a] != date_column[b] ? date_column[a] < date_column[b] : a < b;
+    };
+    for (size_t row = indexed; row < size(); ++row)
+        date_order.push_back(static_cast<std::uint32_t>(row));
+    auto middle = date_order.begin() + indexed;
+    if (!std::is_sorted(middle, date_order.end(), by_date))
+        std::sort(middle, date_order.end(), by_date);
+    if (indexed > 0 && by_date(*middle, *(middle - 1)))
+        std::inplace_merge(date_order.begin(), middle, date_order.end(), by_date);
+
+    sorted_dates.resize(size());
+    sorted_amounts.resize(size());
+    running_in.resize(size());
+    running_out.resize(size());
+    std::int64_t in = 0, out = 0;
+    for (size_t pos = 0; pos < date_order.size(); ++pos)
+    {
+        const int amount = amount_column[date_order[pos]];
+        sorted_dates[pos] = date_column[date_order[pos]];
+        sorted_amounts[pos] = amount;
+        in += amount > 0 ? amount : 0;
+        out -= amount > 0 ? 0 : amount;
+        running_in[pos] = in;
+        running_out[pos] = out;
+    }
+}
+
+void Account_transactions::erase(size_t index)
+{
+    // drop the row from the date index (it is somewhere among the rows on its date), then shift the
+    // indices of the rows that move down one slot
+    if (index < date_order.size())
+    {
+        auto [first, last] = std::equal_range(sorted_dates.begin(), sorted_dates.end(), date_column[index]);
+        auto order_first = date_order.begin() + (first - sorted_dates.begin());
+        auto order_last = date_order.begin() + (last - sorted_dates.begin());
+        size_t pos = static_cast<size_t>(std::find(order_first, order_last, static_cast<std::uint32_t>(index)) - date_order.begin());
+        const int amount = sorted_amounts[pos];
+        date_order.erase(date_order.begin() + pos);
+        sorted_dates.erase(sorted_dates.begin() + pos);
+        sorted_amounts.erase(sorted_amounts.begin() + pos);
+        running_in.erase(running_in.begin() + pos);
+        running_out.erase(running_out.begin() + pos);
+
+        const std::int64_t in = amount > 0 ? amount : 0;
+        const std::int64_t out = amount > 0 ? 0 : -static_cast<std::int64_t>(amount);
+        for (size_t later = pos; later < running_in.size(); ++later)
+        {
+            running_in[later] -= in;
+            running_out[later] -= out;
+        }
+    }
+    for (std::uint32_t& row : date_order)
+        if (row > index)
+            --row;
+
+    ids.erase(ids.begin() + index);
+    sequences.erase(sequences.begin() + index);
+    amount_column.erase(amount_column.begin() + index);
+    date_column.erase(date_column.begin() + index);
+    type_codes.erase(type_codes.begin() + index);
+    category_codes.erase(category_codes.begin() + index);
+    previous_amounts.erase(previous_amounts.begin() + index);
+    new_amounts.erase(new_amounts.begin() + index);
+    notes_loaded.erase(notes_loaded.begin() + index);
+    names.erase(names.begin() + index);
+    notes.erase(notes.begin() + index);
+    revision_number = next_revision();
+}
+
+void Account_transactions::clear()
+{
+    ids.clear();
+    sequences.clear();
+    amount_column.clear();
+    date_column.clear();
+    type_codes.clear();
+    category_codes.clear();
+    previous_amounts.clear();
+    new_amounts.clear();
+    notes_loaded.clear();
+    names.clear();
+    notes.clear();
+    strings.clear();
+    date_order.clear();
+    sorted_dates.clear();
+    sorted_amounts.clear();
+    running_in.clear();
+    running_out.clear();
+    revision_number = 0;
+}
+
+void Account_transactions::reserve(size_t count)
+{
+    ids.reserve(count);
+    sequences.reserve(count);
+    amount_column.reserve(count);
+    date_column.reserve(count);
+    type_codes.reserve(count);
+    category_codes.reserve(count);
+    previous_amounts.reserve(count);
+    new_amounts.reserve(count);
+    notes_loaded.reserve(count);
+    names.reserve(count);
+    notes.reserve(count);
+    date_order.reserve(count);
+    sorted_dates.reserve(count);
+    sorted_amounts.reserve(count);
+    running_in.reserve(count);
+    running_out.reserve(count);
+}
+
+void Account_transactions::set_note(size_t index, std::string_view note)
+{
+    notes[index] = strings.intern(note);
+    notes_loaded[index] = 1;
+}
+
+size_t Account_transactions::memory_bytes() const
+{
+    return ids.capacity() * sizeof(int)
+        + sequences.capacity() * sizeof(std::uint64_t)
+        + amount_column.capacity() * sizeof(int)
+        + date_column.capacity() * sizeof(std::time_t)
+        + type_codes.capacity()
+        + category_codes.capacity()
+        + previous_amounts.capacity() * sizeof(int)
+        + new_amounts.capacity() * sizeof(int)
+        + notes_loaded.capacity()
+        + names.capacity() * sizeof(String_arena::Handle)
+        + notes.capacity() * sizeof(String_arena::Handle)
+        + strings.memory_bytes()
+        + date_order.capacity() * sizeof(std::uint32_t)
+        + sorted_dates.capacity() * sizeof(std::time_t)
+        + sorted_amounts.capacity() * sizeof(int)
+        + running_in.capacity() * sizeof(std::int64_t)
+        + running_out.capacity() * sizeof(std::int64_t);
+}
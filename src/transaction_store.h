@@ -0,0 +1,165 @@
+#pragma once
+#include "amount_kernels.h"
+#include "core_logic.h"
+#include "string_arena.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Read-only view of one row in Account_transactions. Field names match Transaction_info so code
+// that reads rows (the UI tables, tests) works with either. Names and notes are views into the
+// store's String_arena: NUL-terminated, and valid until the account is cleared or reloaded.
+struct Transaction_row
+{
+    int transaction_id;
+    int account_id;
+    int transaction_amount;
+    Transaction_type type_of_transaction;
+    Transaction_category_need transaction_category_need;
+    Transaction_category_want transaction_category_want;
+    int account_previous_amount;
+    int account_new_amount;
+    std::time_t ymd;
+    std::string_view transaction_name;
+    std::string_view note;
+    bool note_loaded;
+
+    Transaction_info to_info() const;
+};
+
+// One account's cached transactions stored column by column, ordered by transaction id.
+// Scans over amounts and dates touch only those arrays; names and notes are interned in a
+// per-account String_arena and each row keeps two 32-bit handles. A second, date-ordered copy of
+// the dates and amounts (ties broken by id) answers [start, end) range queries by binary search,
+// and running inflow/outflow sums over that order turn range totals into two lookups.
+class Account_transactions
+{
+    public:
+        class const_iterator
+        {
+            public:
+                using iterator_category = std::bidirectional_iterator_tag;
+                using value_type = Transaction_row;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = Transaction_row;
+
+                const_iterator() = default;
+                // with an order, position i visits row order[i] instead of row i
+                const_iterator(const Account_transactions* store, size_t index, const std::uint32_t* order = nullptr)
+                    : store(store), index(index), order(order) {}
+
+                Transaction_row operator*() const { return (*store)[order ? order[index] : index]; }
+                const_iterator& operator++() { ++index; return *this; }
+                const_iterator operator++(int) { const_iterator old = *this; ++index; return old; }
+                const_iterator& operator--() { --index; return *this; }
+                const_iterator operator--(int) { const_iterator old = *this; --index; return old; }
+                bool operator==(const const_iterator& other) const = default;
+
+            private:
+                const Account_transactions* store = nullptr;
+                size_t index = 0;
+                const std::uint32_t* order = nullptr;
+        };
+
+        // rows dated in [start, end), oldest first; dates and amounts are the matching contiguous
+        // slices of the date-ordered columns. Invalidated by the next change to the store.
+        struct Date_range
+        {
+            const_iterator first;
+            const_iterator last;
+            std::span<const std::time_t> dates;
+            std::span<const int> amounts;
+
+            const_iterator begin() const { return first; }
+            const_iterator end() const { return last; }
+            size_t size() const { return amounts.size(); }
+            bool empty() const { return amounts.empty(); }
+        };
+
+        size_t size() const { return ids.size(); }
+        bool empty() const { return ids.empty(); }
+        Transaction_row operator[](size_t index) const;
+        Transaction_row front() const { return (*this)[0]; }
+        Transaction_row back() const { return (*this)[size() - 1]; }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, size()); }
+
+        // column access for scans
+        const std::vector<int>& transaction_ids() const { return ids; }
+        // the revision each row was added at: increasing in row order and, unlike ids, never
+        // repeated (SQLite hands a deleted newest row's id to the next insert), so caches that
+        // follow the store across changes match their rows by it
+        const std::vector<std::uint64_t>& row_sequences() const { return sequences; }
+        const std::vector<int>& amounts() const { return amount_column; }
+        const std::vector<std::time_t>& dates() const { return date_column; }
+        // type and category codes as stored (the category is the need or the want one, by type)
+        const std::vector<std::uint8_t>& types() const { return type_codes; }
+        const std::vector<std::uint8_t>& categories() const { return category_codes; }
+        const std::vector<String_arena::Handle>& name_handles() const { return names; }
+        std::string_view string(String_arena::Handle handle) const { return strings.view(handle); }
+        // row indices ordered by (date, id), the date index behind the range queries; rows added
+        // with append() are missing until index_dates()
+        const std::vector<std::uint32_t>& rows_by_date() const { return date_order; }
+
+        // index of the row with this id, or size() if there is none
+        size_t find(int transaction_id) const;
+        Date_range in_date_range(std::time_t start, std::time_t end) const;
+        // money in/out of the rows dated in [start, end), in O(log n)
+        Amount_split totals_in_date_range(std::time_t start, std::time_t end) const;
+        // net amount of every row dated before `when`, in O(log n)
+        std::int64_t net_before(std::time_t when) const;
+
+        // rows must arrive in increasing id order, which is how the database hands them out
+        void push_back(const Transaction_info& trans);
+        void push_back(const Transaction_row& row);   // name/note only need to live for the call
+        // push_back without updating the date index, for bulk loads; call index_dates() once after
+        void append(const Transaction_row& row);
+        // bring the date index up to date with every appended row (sort the new ones, then merge)
+        void index_dates();
+        void erase(size_t index);
+        void clear();
+        void reserve(size_t count);
+        void set_note(size_t index, std::string_view note);
+
+        size_t distinct_string_count() const { return strings.string_count(); }
+
+        // changes whenever rows are added, removed or cleared (not when a note is loaded). Values
+        // are unique across stores and only an empty store reports 0, so anything derived from the
+        // rows can be cached against (store, revision).
+        std::uint64_t revision() const { return revision_number; }
+
+        // heap bytes held by the columns and the string arena
+        size_t memory_bytes() const;
+
+    private:
+        int account_id = 0;   // every row belongs to the same account
+        std::uint64_t revision_number = 0;
+        std::vector<int> ids;
+        std::vector<std::uint64_t> sequences;
+        std::vector<int> amount_column;
+        std::vector<std::time_t> date_column;
+        std::vector<std::uint8_t> type_codes;
+        std::vector<std::uint8_t> category_codes;   // need or want category, depending on the type
+        std::vector<int> previous_amounts;
+        std::vector<int> new_amounts;
+        std::vector<std::uint8_t> notes_loaded;
+
+        std::vector<String_arena::Handle> names;
+        std::vector<String_arena::Handle> notes;
+        String_arena strings;   // freed in one go by clear()
+
+        Amount_split totals_before(size_t pos) const;   // of the first pos rows in date order
+
+        // date index: row indices sorted by (date, id), plus the dates and amounts in that order
+        std::vector<std::uint32_t> date_order;
+        std::vector<std::time_t> sorted_dates;
+        std::vector<int> sorted_amounts;
+        // inflow and outflow totals of date-ordered rows 0..i inclusive
+        std::vector<std::int64_t> running_in;
+        std::vector<std::int64_t> running_out;
+};
@@ -0,0 +1,455 @@
+#include "transaction_table_index.h"
+#include "helpers.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr std::uint32_t dropped = UINT32_MAX;
+
+    char lower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    //case-insensitive first, so "bank" and "Bank" sort together; exact bytes break the tie
+    bool name_less(std::string_view a, std::string_view b)
+    {
+        const size_t common = std::min(a.size(), b.size());
+        for (size_t i = 0; i < common; ++i)
+            if (lower(a[i]) != lower(b[i]))
+                return lower(a[i]) < lower(b[i]);
+        if (a.size() != b.size())
+            return a.size() < b.size();
+        return a < b;
+    }
+
+    bool contains_ignoring_case(std::string_view haystack, std::string_view lowered_needle)
+    {
+        auto found = std::search(haystack.begin(), haystack.end(), lowered_needle.begin(), lowered_needle.end(),
+            [](char h, char n) { return lower(h) == n; });
+        return found != haystack.end();
+    }
+
+    // types and categories sort by the label the table shows, not by enum value
+    std::uint32_t type_rank(std::uint8_t type_code)
+    {
+        static const std::array<std::uint8_t, 8> ranks = []() {
+            std::array<std::uint8_t, 8> codes{};
+            for (std::uint8_t code = 0; code < codes.size(); ++code)
+                codes[code] = code;
+            std::sort(codes.begin(), codes.end(), [](std::uint8_t a, std::uint8_t b) {
+                return std::strcmp(transaction_type_to_string(static_cast<Transaction_type>(a)),
+                                   transaction_type_to_string(static_cast<Transaction_type>(b))) < 0;
+            });
+            std::array<std::uint8_t, 8> by_code{};
+            for (std::uint8_t rank = 0; rank < codes.size(); ++rank)
+                by_code[codes[rank]] = rank;
+            return by_code;
+        }();
+        return ranks[type_code];
+    }
+
+    const char* category_label(std::uint8_t type_code, std::uint8_t category_code)
+    {
+        if (type_code == static_cast<std::uint8_t>(Transaction_type::Need))
+            return transaction_category_need_to_string(static_cast<Transaction_category_need>(category_code));
+        if (type_code == static_cast<std::uint8_t>(Transaction_type::Want))
+            return transaction_category_want_to_string(static_cast<Transaction_category_want>(category_code));
+        return "";
+    }
+
+    // rows without a category (neither Need nor Want) sort first
+    std::uint32_t category_rank(std::uint8_t type_code, std::uint8_t category_code)
+    {
+        // slot = kind * 8 + code, kind 0 for no category, 1 for need, 2 for want
+        static const std::array<std::uint8_t, 24> ranks = []() {
+            std::array<const char*, 24> labels{};
+            for (std::uint8_t code = 0; code < 8; ++code)
+            {
+                labels[code] = "";
+                labels[8 + code] = category_label(static_cast<std::uint8_t>(Transaction_type::Need), code);
+                labels[16 + code] = category_label(static_cast<std::uint8_t>(Transaction_type::Want), code);
+            }
+            std::array<std::uint8_t, 24> slots{};
+            for (std::uint8_t slot = 0; slot < slots.size(); ++slot)
+                slots[slot] = slot;
+            std::sort(slots.begin(), slots.end(), [&labels](std::uint8_t a, std::uint8_t b) {
+                return std::strcmp(labels[a], labels[b]) < 0;
+            });
+            // equal labels ("Other" is both a need and a want category) share a rank
+            std::array<std::uint8_t, 24> by_slot{};
+            std::uint8_t rank = 0;
+            for (size_t pos = 0; pos < slots.size(); ++pos)
+            {
+                if (pos > 0 && std::strcmp(labels[slots[pos]], labels[slots[pos - 1]]) != 0)
+                    ++rank;
+                by_slot[slots[pos]] = rank;
+            }
+            return by_slot;
+        }();
+        size_t kind = 0;
+        if (type_code == static_cast<std::uint8_t>(Transaction_type::Need))
+            kind = 1;
+        else if (type_code == static_cast<std::uint8_t>(Transaction_type::Want))
+            kind = 2;
+        return ranks[kind * 8 + (category_code & 7)];
+    }
+
+    //order holds the rows before first_new already sorted; sort the rest by (key, row) and merge.
+    //Keys below key_count (ranks of names, types, categories) are counting-sorted, which keeps rows
+    //with equal keys in row order for free.
+    template <typename Key>
+    void merge_new_rows(std::vector<std::uint32_t>& order, size_t first_new, size_t size, Key key, size_t key_count = 0)
+    {
+        auto by_key = [&key](std::uint32_t a, std::uint32_t b) {
+            const auto key_a = key(a);
+            const auto key_b = key(b);
+            return key_a != key_b ? key_a < key_b : a < b;
+        };
+        const size_t sorted = order.size();
+        // a handful of new rows (a write): insert each in place rather than merge the whole order
+        if (sorted > 0 && size - first_new <= 16)
+        {
+            for (size_t row = first_new; row < size; ++row)
+            {
+                const std::uint32_t value = static_cast<std::uint32_t>(row);
+                order.insert(std::upper_bound(order.begin(), order.end(), value, by_key), value);
+            }
+            return;
+        }
+        if (key_count > 0)
+        {
+            std::vector<size_t> starts(key_count + 1, 0);
+            for (size_t row = first_new; row < size; ++row)
+                starts[static_cast<size_t>(key(static_cast<std::uint32_t>(row))) + 1]++;
+            for (size_t k = 1; k <= key_count; ++k)
+                starts[k] += starts[k - 1];
+            order.resize(sorted + (size - first_new));
+            for (size_t row = first_new; row < size; ++row)
+                order[sorted + starts[static_cast<size_t>(key(static_cast<std::uint32_t>(row)))]++] = static_cast<std::uint32_t>(row);
+        }
+        else
+        {
+            for (size_t row = first_new; row < size; ++row)
+                order.push_back(static_cast<std::uint32_t>(row));
+            std::sort(order.begin() + sorted, order.end(), by_key);
+        }
+        auto middle = order.begin() + sorted;
+        if (sorted > 0 && middle != order.end() && by_key(*middle, *(middle - 1)))
+            std::inplace_merge(order.begin(), middle, order.end(), by_key);
+    }
+
+    void set_bit(std::vector<std::uint64_t>& bits, size_t row)
+    {
+        bits[row >> 6] |= std::uint64_t{1} << (row & 63);
+    }
+
+    bool test_bit(const std::vector<std::uint64_t>& bits, size_t row)
+    {
+        return (bits[row >> 6] >> (row & 63)) & 1;
+    }
+
+    void and_into(std::vector<std::uint64_t>& into, const std::vector<std::uint64_t>& other)
+    {
+        for (size_t word = 0; word < into.size(); ++word)
+            into[word] &= other[word];
+    }
+
+    //bitmap of the rows in order[first, last)
+    std::vector<std::uint64_t> rows_in(const std::vector<std::uint32_t>& order, size_t first, size_t last, size_t words)
+    {
+        std::vector<std::uint64_t> bits(words, 0);
+        for (size_t pos = first; pos < last; ++pos)
+            set_bit(bits, order[pos]);
+        return bits;
+    }
+}
+
+std::span<const std::uint32_t> Transaction_table_index::rows_for(const Account_transactions& rows, const Transaction_query& query)
+{
+    sync(rows);
+    if (result_valid && result_query == query)
+        return result;
+
+    const Bitmap& bits = matching(rows, query.filter);
+    const std::vector<std::uint32_t>& order = permutation(query.column, rows);
+    result.clear();
+    result.reserve(rows.size());
+    if (query.descending)
+    {
+        for (size_t pos = order.size(); pos-- > 0;)
+            if (test_bit(bits, order[pos]))
+                result.push_back(order[pos]);
+    }
+    else
+    {
+        for (std::uint32_t row : order)
+            if (test_bit(bits, row))
+                result.push_back(row);
+    }
+    result_valid = true;
+    result_query = query;
+    return result;
+}
+
+//bring the permutations and bitmaps up to date with the rows. Rows are matched by sequence, not id:
+//a re-inserted id is a different row. Sequences only grow, so the rows that are still there keep
+//their relative order and everything after them is new
+void Transaction_table_index::sync(const Account_transactions& rows)
+{
+    if (source == &rows && revision == rows.revision())
+        return;
+
+    const std::vector<std::uint64_t>& now = rows.row_sequences();
+    std::vector<std::uint32_t> new_index;
+    size_t kept = 0;
+    bool removed = false;
+    if (source == &rows && !sequences.empty() && sequences.size() <= now.size() && now[sequences.size() - 1] == sequences.back())
+        kept = sequences.size();   // only appended: with sequences increasing, the last old one in place means all of them are
+    else
+    {
+        new_index.assign(sequences.size(), dropped);
+        if (source == &rows)
+        {
+            for (size_t old = 0; old < sequences.size() && kept < now.size(); ++old)
+                if (sequences[old] == now[kept])
+                    new_index[old] = static_cast<std::uint32_t>(kept++);
+        }
+        removed = kept != sequences.size();
+    }
+
+    for (size_t column = 0; column < column_count; ++column)
+    {
+        if (!built[column])
+            continue;
+        std::vector<std::uint32_t>& order = orders[column];
+        if (removed)
+        {
+            size_t out = 0;
+            for (std::uint32_t row : order)
+                if (new_index[row] != dropped)
+                    order[out++] = new_index[row];
+            order.resize(out);
+        }
+        if (column == static_cast<size_t>(Transaction_sort_column::Name) && kept < rows.size())
+            rank_names(rows);
+        sort_into(static_cast<Transaction_sort_column>(column), rows, kept);
+    }
+
+    // bitmaps can only gain rows at the end; after a removal every bit moves, so rebuild them
+    const size_t words = (rows.size() + 63) / 64;
+    const size_t first_new = removed ? 0 : kept;
+    for (size_t code = 0; code < code_count; ++code)
+    {
+        if (removed)
+        {
+            type_bits[code].clear();
+            category_bits[code].clear();
+        }
+        type_bits[code].resize(words, 0);
+        category_bits[code].resize(words, 0);
+    }
+    const std::vector<std::uint8_t>& types = rows.types();
+    const std::vector<std::uint8_t>& categories = rows.categories();
+    for (size_t row = first_new; row < rows.size(); ++row)
+    {
+        set_bit(type_bits[types[row] & 7], row);
+        set_bit(category_bits[categories[row] & 7], row);
+    }
+
+    // the current filter only has to be evaluated for the new rows
+    if (match_valid && !removed)
+    {
+        match.resize(words, 0);
+        handle_matches.resize(rows.distinct_string_count(), 2);
+        for (size_t row = kept; row < rows.size(); ++row)
+            if (row_matches(rows, match_filter, row))
+                set_bit(match, row);
+    }
+    else
+        match_valid = false;
+
+    source = &rows;
+    revision = rows.revision();
+    if (removed)
+        sequences = now;
+    else
+        sequences.insert(sequences.end(), now.begin() + static_cast<std::ptrdiff_t>(kept), now.end());
+    result_valid = false;
+}
+
+//one row against the filter, for rows added after the bitmap was built
+bool Transaction_table_index::row_matches(const Account_transactions& rows, const Transaction_filter& filter, size_t row)
+{
+    const Transaction_type type = static_cast<Transaction_type>(rows.types()[row]);
+    const std::uint8_t category = rows.categories()[row];
+    const int amount = rows.amounts()[row];
+    const std::time_t date = rows.dates()[row];
+    if (filter.type && type != *filter.type)
+        return false;
+    if (filter.need_category && (type != Transaction_type::Need || category != static_cast<std::uint8_t>(*filter.need_category)))
+        return false;
+    if (filter.want_category && (type != Transaction_type::Want || category != static_cast<std::uint8_t>(*filter.want_category)))
+        return false;
+    if ((filter.min_amount && amount < *filter.min_amount) || (filter.max_amount && amount > *filter.max_amount))
+        return false;
+    if ((filter.start && date < *filter.start) || (filter.end && date >= *filter.end))
+        return false;
+    if (!filter.text.empty())
+        return name_matches(rows, rows.name_handles()[row]);
+    return true;
+}
+
+//text filter for one distinct name, searched once per filter: 0 no, 1 yes, 2 not looked at yet
+bool Transaction_table_index::name_matches(const Account_transactions& rows, String_arena::Handle handle)
+{
+    std::uint8_t& found = handle_matches[handle];
+    if (found == 2)
+        found = contains_ignoring_case(rows.string(handle), lowered_text) ? 1 : 0;
+    return found == 1;
+}
+
+const std::vector<std::uint32_t>& Transaction_table_index::permutation(Transaction_sort_column column, const Account_transactions& rows)
+{
+    if (column == Transaction_sort_column::Date)
+        return rows.rows_by_date();
+
+    const size_t slot = static_cast<size_t>(column);
+    if (!built[slot])
+    {
+        orders[slot].clear();
+        orders[slot].reserve(rows.size());
+        if (column == Transaction_sort_column::Name)
+            rank_names(rows);
+        sort_into(column, rows, 0);
+        built[slot] = true;
+    }
+    return orders[slot];
+}
+
+void Transaction_table_index::sort_into(Transaction_sort_column column, const Account_transactions& rows, size_t first_new)
+{
+    std::vector<std::uint32_t>& order = orders[static_cast<size_t>(column)];
+    const size_t size = rows.size();
+    if (first_new >= size)
+        return;
+    sorted_count += static_cast<long long>(size - first_new);
+
+    switch (column)
+    {
+        case Transaction_sort_column::Name:
+        {
+            const std::vector<String_arena::Handle>& names = rows.name_handles();
+            merge_new_rows(order, first_new, size, [this, &names](std::uint32_t row) { return name_rank[names[row]]; }, name_rank.size());
+            break;
+        }
+        case Transaction_sort_column::Amount:
+        {
+            const std::vector<int>& amounts = rows.amounts();
+            merge_new_rows(order, first_new, size, [&amounts](std::uint32_t row) { return amounts[row]; });
+            break;
+        }
+        case Transaction_sort_column::Type:
+        {
+            const std::vector<std::uint8_t>& types = rows.types();
+            merge_new_rows(order, first_new, size, [&types](std::uint32_t row) { return type_rank(types[row]); }, code_count);
+            break;
+        }
+        case Transaction_sort_column::Category:
+        {
+            const std::vector<std::uint8_t>& types = rows.types();
+            const std::vector<std::uint8_t>& categories = rows.categories();
+            merge_new_rows(order, first_new, size, [&types, &categories](std::uint32_t row) {
+                return category_rank(types[row], categories[row]);
+            }, 3 * code_count);
+            break;
+        }
+        case Transaction_sort_column::Date:
+            break;
+    }
+}
+
+//rank every interned string in name order; the relative order of existing strings never changes,
+//so permutations sorted by the old ranks stay sorted under the new ones
+void Transaction_table_index::rank_names(const Account_transactions& rows)
+{
+    const size_t count = rows.distinct_string_count();
+    std::vector<String_arena::Handle> handles(count);
+    for (size_t handle = 0; handle < count; ++handle)
+        handles[handle] = static_cast<String_arena::Handle>(handle);
+    std::sort(handles.begin(), handles.end(), [&rows](String_arena::Handle a, String_arena::Handle b) {
+        return name_less(rows.string(a), rows.string(b));
+    });
+    name_rank.assign(count, 0);
+    for (size_t rank = 0; rank < count; ++rank)
+        name_rank[handles[rank]] = static_cast<std::uint32_t>(rank);
+}
+
+const Transaction_table_index::Bitmap& Transaction_table_index::matching(const Account_transactions& rows, const Transaction_filter& filter)
+{
+    if (match_valid && match_filter == filter)
+        return match;
+
+    const size_t size = rows.size();
+    const size_t words = (size + 63) / 64;
+    match.assign(words, ~std::uint64_t{0});
+    if (size % 64 != 0)
+        match.back() = (std::uint64_t{1} << (size % 64)) - 1;
+
+    if (filter.type)
+        and_into(match, type_bits[static_cast<size_t>(*filter.type)]);
+    if (filter.need_category)
+    {
+        and_into(match, type_bits[static_cast<size_t>(Transaction_type::Need)]);
+        and_into(match, category_bits[static_cast<size_t>(*filter.need_category)]);
+    }
+    if (filter.want_category)
+    {
+        and_into(match, type_bits[static_cast<size_t>(Transaction_type::Want)]);
+        and_into(match, category_bits[static_cast<size_t>(*filter.want_category)]);
+    }
+
+    // ranges are contiguous slices of the sorted permutations
+    if (filter.min_amount || filter.max_amount)
+    {
+        const std::vector<std::uint32_t>& order = permutation(Transaction_sort_column::Amount, rows);
+        const std::vector<int>& amounts = rows.amounts();
+        auto first = order.begin();
+        auto last = order.end();
+        if (filter.min_amount)
+            first = std::partition_point(order.begin(), order.end(), [&](std::uint32_t row) { return amounts[row] < *filter.min_amount; });
+        if (filter.max_amount)
+            last = std::partition_point(first, order.end(), [&](std::uint32_t row) { return amounts[row] <= *filter.max_amount; });
+        and_into(match, rows_in(order, first - order.begin(), last - order.begin(), words));
+    }
+    if (filter.start || filter.end)
+    {
+        const std::vector<std::uint32_t>& order = rows.rows_by_date();
+        const std::vector<std::time_t>& dates = rows.dates();
+        auto first = order.begin();
+        auto last = order.end();
+        if (filter.start)
+            first = std::partition_point(order.begin(), order.end(), [&](std::uint32_t row) { return dates[row] < *filter.start; });
+        if (filter.end)
+            last = std::partition_point(first, order.end(), [&](std::uint32_t row) { return dates[row] < *filter.end; });
+        and_into(match, rows_in(order, first - order.begin(), last - order.begin(), words));
+    }
+
+    // names repeat, so each distinct one is searched once
+    if (!filter.text.empty())
+    {
+        lowered_text = filter.text;
+        for (char& c : lowered_text)
+            c = lower(c);
+        handle_matches.assign(rows.distinct_string_count(), 2);
+        const std::vector<String_arena::Handle>& names = rows.name_handles();
+        for (size_t row = 0; row < size; ++row)
+            if (test_bit(match, row) && !name_matches(rows, names[row]))
+                match[row >> 6] &= ~(std::uint64_t{1} << (row & 63));
+    }
+
+    match_valid = true;
+    match_filter = filter;
+    return match;
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "transaction_store.h"
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+enum class Transaction_sort_column
+{
+    Name,
+    Amount,
+    Type,
+    Category,
+    Date
+};
+
+// Which rows a transaction table shows; an unset field does not filter
+struct Transaction_filter
+{
+    std::optional<Transaction_type> type;
+    std::optional<Transaction_category_need> need_category;   // only matches Need rows
+    std::optional<Transaction_category_want> want_category;   // only matches Want rows
+    std::optional<int> min_amount;          // cents, inclusive
+    std::optional<int> max_amount;          // cents, inclusive
+    std::optional<std::time_t> start;       // [start, end)
+    std::optional<std::time_t> end;
+    std::string text;                       // case-insensitive substring of the name; empty matches all
+
+    bool operator==(const Transaction_filter& other) const = default;
+};
+
+struct Transaction_query
+{
+    Transaction_filter filter;
+    Transaction_sort_column column = Transaction_sort_column::Date;
+    bool descending = true;
+
+    bool operator==(const Transaction_query& other) const = default;
+};
+
+// Sort and filter index over one account's Account_transactions, for tables that re-sort and
+// re-filter every row at interactive rates. Each column keeps a permutation of the row indices
+// sorted by (value, id), built the first time the column is sorted on; the date one is the store's
+// own date index. Type and category keep one bitmap per value. When the store changes, surviving
+// rows keep their place, new rows are sorted and merged in, and bitmaps (the current filter's too)
+// only gain bits unless rows were removed. A query is then a walk over one permutation testing one
+// combined bitmap, with the amount and date ranges read off their permutations by binary search.
+class Transaction_table_index
+{
+    public:
+        // indices into `rows` of the rows matching query.filter, in the query's order. Valid until
+        // the next call; repeating a query on unchanged rows returns the previous result.
+        std::span<const std::uint32_t> rows_for(const Account_transactions& rows, const Transaction_query& query);
+
+        // how many rows have been sorted into a permutation so far (a full sort counts every row)
+        long long rows_sorted() const { return sorted_count; }
+
+    private:
+        using Bitmap = std::vector<std::uint64_t>;
+        static constexpr size_t column_count = 4;   // Date uses the store's index
+        static constexpr size_t code_count = 8;     // type and category codes are below 8
+
+        void sync(const Account_transactions& rows);
+        const std::vector<std::uint32_t>& permutation(Transaction_sort_column column, const Account_transactions& rows);
+        void sort_into(Transaction_sort_column column, const Account_transactions& rows, size_t first_new);
+        void rank_names(const Account_transactions& rows);
+        const Bitmap& matching(const Account_transactions& rows, const Transaction_filter& filter);
+        bool row_matches(const Account_transactions& rows, const Transaction_filter& filter, size_t row);
+        bool name_matches(const Account_transactions& rows, String_arena::Handle handle);
+
+        const Account_transactions* source = nullptr;
+        std::uint64_t revision = 0;
+        std::vector<std::uint64_t> sequences;   // row sequences as of the last sync, to match rows across changes
+
+        std::array<std::vector<std::uint32_t>, column_count> orders;
+        std::array<bool, column_count> built{};
+        std::vector<std::uint32_t> name_rank;   // by String_arena handle, in case-insensitive name order
+
+        std::array<Bitmap, code_count> type_bits;
+        std::array<Bitmap, code_count> category_bits;
+
+        bool match_valid = false;
+        Transaction_filter match_filter;
+        Bitmap match;
+        std::string lowered_text;                   // the text filter, lower-cased
+        std::vector<std::uint8_t> handle_matches;   // text filter result per distinct name
+
+        bool result_valid = false;
+        Transaction_query result_query;
+        std::vector<std::uint32_t> result;
+
+        long long sorted_count = 0;
+};
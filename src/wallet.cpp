@@ -0,0 +1,52 @@
+#include "wallet.h"
+#include <algorithm>
+
+const Account_info* Wallet_snapshot::find(int account_id) const
+{
+    for (const Entry& entry : accounts)
+        if (entry->account_id == account_id)
+            return entry.get();
+    return nullptr;
+}
+
+Wallet::Wallet() : current(std::make_shared<const Wallet_snapshot>()) {}
+
+void Wallet::publish(const std::vector<Account_info>& accounts)
+{
+    std::vector<Wallet_snapshot::Entry> entries;
+    entries.reserve(accounts.size());
+    for (const Account_info& acc : accounts)
+        entries.push_back(std::make_shared<const Account_info>(acc));
+    current.store(std::make_shared<const Wallet_snapshot>(std::move(entries)), std::memory_order_release);
+}
+
+void Wallet::put(const Account_info& account)
+{
+    auto entry = std::make_shared<const Account_info>(account);
+    update([&entry](const std::vector<Wallet_snapshot::Entry>& entries) -> std::optional<std::vector<Wallet_snapshot::Entry>>
+    {
+        std::vector<Wallet_snapshot::Entry> next = entries;
+        auto existing = std::find_if(next.begin(), next.end(),
+            [&entry](const Wallet_snapshot::Entry& e) { return e->account_id == entry->account_id; });
+        if (existing != next.end())
+            *existing = entry;
+        else
+            next.push_back(entry);
+        return next;
+    });
+}
+
+bool Wallet::remove(int account_id)
+{
+    return update([account_id](const std::vector<Wallet_snapshot::Entry>& entries) -> std::optional<std::vector<Wallet_snapshot::Entry>>
+    {
+        std::vector<Wallet_snapshot::Entry> next;
+        next.reserve(entries.size());
+        for (const Wallet_snapshot::Entry& entry : entries)
+            if (entry->account_id != account_id)
+                next.push_back(entry);
+        if (next.size() == entries.size())
+            return std::nullopt;
+        return next;
+    });
+}
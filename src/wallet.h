@@ -0,0 +1,128 @@
+#pragma once
+#include "storage.h"
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// An immutable list of accounts. Entries are shared between snapshots, so a new snapshot that
+// changes one account copies that Account_info and the pointer array, nothing else.
+class Wallet_snapshot
+{
+    public:
+        using Entry = std::shared_ptr<const Account_info>;
+
+        class const_iterator
+        {
+            public:
+                using iterator_category = std::random_access_iterator_tag;
+                using value_type = Account_info;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const Account_info*;
+                using reference = const Account_info&;
+
+                const_iterator() = default;
+                explicit const_iterator(std::vector<Entry>::const_iterator it) : it(it) {}
+
+                const Account_info& operator*() const { return **it; }
+                const Account_info* operator->() const { return it->get(); }
+                const_iterator& operator++() { ++it; return *this; }
+                const_iterator operator++(int) { const_iterator old = *this; ++it; return old; }
+                bool operator==(const const_iterator& other) const = default;
+
+            private:
+                std::vector<Entry>::const_iterator it;
+        };
+
+        Wallet_snapshot() = default;
+        explicit Wallet_snapshot(std::vector<Entry> entries) : accounts(std::move(entries)) {}
+
+        size_t size() const { return accounts.size(); }
+        bool empty() const { return accounts.empty(); }
+        const Account_info& operator[](size_t index) const { return *accounts[index]; }
+        const_iterator begin() const { return const_iterator(accounts.begin()); }
+        const_iterator end() const { return const_iterator(accounts.end()); }
+
+        // the account with this id, or nullptr
+        const Account_info* find(int account_id) const;
+        const std::vector<Entry>& entries() const { return accounts; }
+
+    private:
+        std::vector<Entry> accounts;
+};
+
+// The published account list. Readers take a snapshot() handle (one atomic load and a reference
+// count) and keep using it however many times the wallet is republished meanwhile; writers swap
+// in a new snapshot atomically. The convenience accessors read through the current snapshot and
+// their references only last until the next publish, so hold a snapshot across any write.
+class Wallet
+{
+    public:
+        Wallet();
+        Wallet(const Wallet&) = delete;
+        Wallet& operator=(const Wallet&) = delete;
+
+        // a panel that takes a reference to an account and then writes (create, modify, delete)
+        // keeps the handle for the whole draw: the write publishes a new snapshot, and the old one,
+        // which the reference points into, lives only as long as a handle to it
+        std::shared_ptr<const Wallet_snapshot> snapshot() const { return current.load(std::memory_order_acquire); }
+
+        // replace every entry
+        void publish(const std::vector<Account_info>& accounts);
+        // publish a copy with change(account) applied to one account; false if no account has this id
+        template <typename Change>
+        bool patch(int account_id, Change change);
+        // replace the entry with this account's id, or append it if there is none
+        void put(const Account_info& account);
+        // false if no account has this id
+        bool remove(int account_id);
+
+        size_t size() const { return snapshot()->size(); }
+        bool empty() const { return snapshot()->empty(); }
+        const Account_info& operator[](size_t index) const { return (*snapshot())[index]; }
+
+    private:
+        // edit(entries) returns the next entry list, or nullopt to leave the wallet as it is
+        template <typename Edit>
+        bool update(Edit edit);
+
+        std::atomic<std::shared_ptr<const Wallet_snapshot>> current;
+};
+
+template <typename Edit>
+bool Wallet::update(Edit edit)
+{
+    std::shared_ptr<const Wallet_snapshot> old_snapshot = snapshot();
+    for (;;)
+    {
+        std::optional<std::vector<Wallet_snapshot::Entry>> next = edit(old_snapshot->entries());
+        if (!next)
+            return false;
+        auto next_snapshot = std::make_shared<const Wallet_snapshot>(std::move(*next));
+        // another writer may have published since the load; redo the edit on top of theirs
+        if (current.compare_exchange_weak(old_snapshot, std::move(next_snapshot), std::memory_order_acq_rel))
+            return true;
+    }
+}
+
+template <typename Change>
+bool Wallet::patch(int account_id, Change change)
+{
+    return update([account_id, &change](const std::vector<Wallet_snapshot::Entry>& entries)
+        -> std::optional<std::vector<Wallet_snapshot::Entry>>
+    {
+        size_t index = 0;
+        while (index < entries.size() && entries[index]->account_id != account_id)
+            ++index;
+        if (index == entries.size())
+            return std::nullopt;
+
+        auto changed = std::make_shared<Account_info>(*entries[index]);
+        change(*changed);
+        std::vector<Wallet_snapshot::Entry> next = entries;
+        next[index] = std::move(changed);
+        return next;
+    });
+}
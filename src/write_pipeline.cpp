@@ -0,0 +1,126 @@
+#include "write_pipeline.h"
+#include <algorithm>
+
+namespace
+{
+    // the writer only writes; it has no use for a read-only pool, and its changes reach the UI
+    // Storage's cache through the completions, so keeping a second copy of every row is waste
+    Storage_options writer_options(Storage_options options)
+    {
+        options.read_connections = 0;
+        options.cache_writes = false;
+        return options;
+    }
+}
+
+Write_pipeline::Write_pipeline(const std::string& db_path, const Storage_options& options)
+    : writer_db(db_path, writer_options(options)), writer([this]() { writer_loop(); })
+{
+}
+
+Write_pipeline::~Write_pipeline()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_available.notify_one();
+    writer.join();
+}
+
+void Write_pipeline::submit(Command command)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        commands.push_back({std::move(command), std::chrono::steady_clock::now()});
+    }
+    work_available.notify_one();
+}
+
+void Write_pipeline::set_completion_notifier(Notifier notifier)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    completion_notifier = std::move(notifier);
+}
+
+void Write_pipeline::writer_loop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        work_available.wait(lock, [this]() { return stopping || !commands.empty(); });
+        if (commands.empty())
+            return;   // stopping and drained
+
+        Queued_command queued = std::move(commands.front());
+        commands.pop_front();
+        in_flight++;
+        lock.unlock();
+
+        auto started_at = std::chrono::steady_clock::now();
+        Completion completion = queued.command(writer_db);
+        auto finished_at = std::chrono::steady_clock::now();
+
+        lock.lock();
+        in_flight--;
+        const bool queued_completion = static_cast<bool>(completion);
+        if (queued_completion)
+            completions.push_back(std::move(completion));
+
+        double commit_ms = std::chrono::duration<double, std::milli>(finished_at - started_at).count();
+        counters.commands_committed++;
+        counters.last_commit_ms = commit_ms;
+        counters.max_commit_ms = std::max(counters.max_commit_ms, commit_ms);
+        counters.last_submit_to_commit_ms = std::chrono::duration<double, std::milli>(finished_at - queued.submitted_at).count();
+        total_commit_ms += commit_ms;
+
+        if (commands.empty() && in_flight == 0)
+            drained.notify_all();
+
+        // outside the lock: the notifier may call back into stats() or take its own locks
+        if (queued_completion && completion_notifier)
+        {
+            Notifier notify = completion_notifier;
+            lock.unlock();
+            notify();
+            lock.lock();
+        }
+    }
+}
+
+//the two deques trade places under the lock, so neither allocates once it has grown: called every
+//frame, an empty check costs a lock and nothing else
+int Write_pipeline::process_completions()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready_completions.swap(completions);
+    }
+    for (Completion& completion : ready_completions)
+    {
+        completion();
+    }
+    const int ran = static_cast<int>(ready_completions.size());
+    ready_completions.clear();
+    return ran;
+}
+
+void Write_pipeline::flush()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        drained.wait(lock, [this]() { return commands.empty() && in_flight == 0; });
+    }
+    process_completions();
+}
+
+Write_pipeline_stats Write_pipeline::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Write_pipeline_stats snapshot = counters;
+    snapshot.queue_depth = commands.size() + in_flight;
+    snapshot.completions_pending = completions.size();
+    if (counters.commands_committed > 0)
+        snapshot.average_commit_ms = total_commit_ms / counters.commands_committed;
+    return snapshot;
+}
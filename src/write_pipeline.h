@@ -0,0 +1,80 @@
+#pragma once
+#include "storage.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct Write_pipeline_stats
+{
+    size_t queue_depth = 0;            // submitted commands not yet committed (including the one running)
+    size_t completions_pending = 0;    // committed, waiting for process_completions()
+    long long commands_committed = 0;
+    double last_commit_ms = 0.0;       // time the writer spent on the most recent command
+    double average_commit_ms = 0.0;
+    double max_commit_ms = 0.0;
+    double last_submit_to_commit_ms = 0.0;   // including time spent queued
+};
+
+// Runs database writes on a dedicated thread so the UI frame never waits on an fsync.
+// The writer owns its own Storage (its own SQLite connection) on the same file, so db_path must be
+// a real file; WAL (Storage_options::fast_interactive) lets the UI connection keep reading meanwhile.
+//
+// A command runs on the writer thread against the writer's Storage and returns a completion;
+// completions run on the UI thread inside process_completions(), which is where App_state and the
+// UI-side Storage cache get updated.
+class Write_pipeline
+{
+    public:
+        using Completion = std::function<void()>;
+        using Command = std::function<Completion(Storage& writer_db)>;
+        using Notifier = std::function<void()>;
+
+        explicit Write_pipeline(const std::string& db_path, const Storage_options& options = {});
+        ~Write_pipeline();   // commits everything already submitted, then joins
+
+        Write_pipeline(const Write_pipeline&) = delete;
+        Write_pipeline& operator=(const Write_pipeline&) = delete;
+
+        void submit(Command command);
+
+        // called on the writer thread each time a completion is queued, so a UI loop that sleeps
+        // while idle can wake up and run process_completions() (e.g. glfwPostEmptyEvent)
+        void set_completion_notifier(Notifier notifier);
+
+        // UI thread only: run the completions of every command committed so far; returns how many ran
+        int process_completions();
+
+        // UI thread only: wait until every submitted command has committed, then process_completions()
+        void flush();
+
+        Write_pipeline_stats stats() const;
+
+    private:
+        struct Queued_command
+        {
+            Command command;
+            std::chrono::steady_clock::time_point submitted_at;
+        };
+
+        void writer_loop();
+
+        Storage writer_db;
+
+        mutable std::mutex mutex;
+        std::condition_variable work_available;
+        std::condition_variable drained;
+        std::deque<Queued_command> commands;
+        std::deque<Completion> completions;
+        std::deque<Completion> ready_completions;   // UI thread only: the batch process_completions() is running
+        Notifier completion_notifier;
+        size_t in_flight = 0;
+        bool stopping = false;
+        Write_pipeline_stats counters;
+        double total_commit_ms = 0.0;
+
+        std::thread writer;   // last member: starts once everything above is constructed
+};
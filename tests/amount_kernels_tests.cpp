@@ -0,0 +1,71 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/amount_kernels.h"
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+// split_amounts unit tests: every SIMD path must give exactly the scalar path's totals, including
+// for the leftover tail and for sums that would overflow 32 bits.
+
+namespace
+{
+    const Simd_level all_levels[] = {Simd_level::scalar, Simd_level::sse2, Simd_level::avx2};
+
+    std::vector<std::int32_t> mixed_amounts(size_t count)
+    {
+        std::vector<std::int32_t> amounts;
+        std::uint32_t seed = 12345;
+        for (size_t i = 0; i < count; ++i)
+        {
+            seed = seed * 1103515245u + 12345u;
+            amounts.push_back(static_cast<std::int32_t>(seed % 2000001u) - 1000000);
+        }
+        return amounts;
+    }
+}
+
+TEST_CASE("split_amounts separates money in from money out", "[kernels]") {
+    // Zero counts as money out (adding nothing), matching the summaries' "amount > 0 is income" rule.
+    std::vector<std::int32_t> amounts = {5000, -2000, 0, 300, -1, 7};
+    for (Simd_level level : all_levels)
+    {
+        Amount_split split = split_amounts(level, amounts.data(), amounts.size());
+        REQUIRE(split.money_in == 5307);
+        REQUIRE(split.money_out == 2001);
+    }
+    REQUIRE(split_amounts(amounts.data(), 0) == Amount_split{});
+}
+
+TEST_CASE("split_amounts SIMD paths match the scalar path exactly", "[kernels]") {
+    // Lengths around the vector widths exercise every tail size.
+    std::vector<std::int32_t> amounts = mixed_amounts(1037);
+    std::vector<std::int64_t> wide(amounts.begin(), amounts.end());
+    for (size_t count : {size_t{0}, size_t{1}, size_t{3}, size_t{7}, size_t{8}, size_t{9}, size_t{1037}})
+    {
+        Amount_split expected = split_amounts(Simd_level::scalar, amounts.data(), count);
+        for (Simd_level level : all_levels)
+        {
+            REQUIRE(split_amounts(level, amounts.data(), count) == expected);
+            REQUIRE(split_amounts(level, wide.data(), count) == expected);
+        }
+    }
+}
+
+TEST_CASE("split_amounts keeps 64-bit totals", "[kernels]") {
+    // A few thousand extreme amounts overflow any 32-bit accumulator.
+    std::vector<std::int32_t> amounts;
+    for (int i = 0; i < 4001; ++i)
+        amounts.push_back(i % 2 == 0 ? INT_MAX : INT_MIN);
+    std::vector<std::int64_t> wide = {INT64_C(1) << 40, -(INT64_C(1) << 41), 3, -4, INT64_C(1) << 40};
+
+    for (Simd_level level : all_levels)
+    {
+        Amount_split split = split_amounts(level, amounts.data(), amounts.size());
+        REQUIRE(split.money_in == INT64_C(2001) * INT_MAX);
+        REQUIRE(split.money_out == INT64_C(2000) * -static_cast<std::int64_t>(INT_MIN));
+
+        Amount_split wide_split = split_amounts(level, wide.data(), wide.size());
+        REQUIRE(wide_split.money_in == (INT64_C(1) << 41) + 3);
+        REQUIRE(wide_split.money_out == (INT64_C(1) << 41) + 4);
+    }
+}
@@ -10,7 +10,7 @@
 // we use an in-memory DB and a fresh App_state so each test is isolated.
 
 TEST_CASE("create_account persists account and refreshes state.wallet", "[controller][accounts]") {
-    // Ensures the controller saves the account to storage and calls reload_wallet so the UI's
+    // Ensures the controller saves the account to storage and adds it to state.wallet so the UI's
     // wallet list is updated, and that it closes the "new account" panel state.
     Storage store(":memory:");
     App_state state;
@@ -103,7 +103,7 @@ TEST_CASE("create_transaction persists transaction and closes create-transaction
         "Groceries", "", 10000, 7500);
     ctrl.create_transaction(account_id, trans);
 
-    const std::vector<Transaction_info>& list = ctrl.get_transactions(account_id);
+    const Account_transactions& list = ctrl.get_transactions(account_id);
     REQUIRE(list.size() == 1u);
     REQUIRE(list[0].transaction_amount == -2500);
     REQUIRE(list[0].transaction_name == "Groceries");
@@ -160,9 +160,9 @@ TEST_CASE("get_transactions returns same data as storage for account", "[control
         "Test", "note", 0, 500);
     ctrl.create_transaction(account_id, trans);
 
-    const std::vector<Transaction_info>& via_ctrl = ctrl.get_transactions(account_id);
+    const Account_transactions& via_ctrl = ctrl.get_transactions(account_id);
     store.load_transactions(account_id);
-    const std::vector<Transaction_info>& via_storage = store.get_transactions(account_id);
+    const Account_transactions& via_storage = store.get_transactions(account_id);
     REQUIRE(via_ctrl.size() == via_storage.size());
     REQUIRE(via_ctrl[0].transaction_id == via_storage[0].transaction_id);
     REQUIRE(via_ctrl[0].transaction_amount == via_storage[0].transaction_amount);
@@ -203,6 +203,44 @@ TEST_CASE("get_monthly_summary aggregates transactions in date range", "[control
     REQUIRE(summary.money_remaining == 4000);
 }
 
+TEST_CASE("get_net_worth_series adds assets and subtracts liabilities at each time", "[controller][read]") {
+    // Net worth at a past month-end must use each account's balance as of that time, with
+    // amounts owed on liabilities counted against it.
+    Storage store(":memory:");
+    App_state state;
+    Controller ctrl(state, store);
+
+    Account checking("Checking", Account_type::checking, 10000, true);
+    Liability_parameters card_params{};
+    Account card("Card", Account_type::credit_card, 3000, false, card_params);
+    ctrl.create_account(checking);
+    ctrl.create_account(card);
+    store.load_all_transactions();
+    int checking_id = state.wallet[0].account_id;
+    int card_id = state.wallet[1].account_id;
+
+    std::time_t jan_1 = 1704067200;
+    std::time_t feb_1 = 1706745600;
+    std::time_t mar_1 = 1709251200;
+
+    Transaction_info pay = create_transaction_info(
+        checking_id, 4000, Transaction_type::Income,
+        Transaction_category_need::Other, Transaction_category_want::Other, "Pay", "", 10000, 14000);
+    pay.ymd = jan_1 + 3600;
+    ctrl.create_transaction(checking_id, pay);
+
+    Transaction_info spend = create_transaction_info(
+        card_id, 1500, Transaction_type::Want,
+        Transaction_category_need::Other, Transaction_category_want::Other, "Spend", "", 3000, 4500);
+    spend.ymd = feb_1 + 3600;
+    ctrl.create_transaction(card_id, spend);
+
+    std::vector<std::time_t> month_starts = {jan_1, feb_1, mar_1};
+    REQUIRE(ctrl.get_net_worth_series(month_starts) == std::vector<std::int64_t>{7000, 11000, 9500});
+    REQUIRE(ctrl.get_net_worth_at(mar_1) == 9500);
+    REQUIRE(ctrl.get_balance_at(card_id, feb_1) == 3000);
+}
+
 TEST_CASE("create_internal_transfer updates both accounts and refreshes wallet", "[controller][transfer]") {
     // Ensures an internal transfer through the controller creates both transaction rows and
     // that reload_wallet runs so state.wallet shows updated balances for both accounts.
@@ -230,7 +268,8 @@ TEST_CASE("create_internal_transfer updates both accounts and refreshes wallet",
 
     REQUIRE(state.wallet.size() == 2u);
     int from_balance = 0, to_balance = 0;
-    for (const auto& a : state.wallet) {
+    std::shared_ptr<const Wallet_snapshot> wallet = state.wallet.snapshot();
+    for (const auto& a : *wallet) {
         if (a.account_id == from_id) from_balance = a.money_amount;
         if (a.account_id == to_id) to_balance = a.money_amount;
     }
@@ -247,3 +286,129 @@ TEST_CASE("get_transactions returns empty for unknown account_id", "[controller]
 
     REQUIRE(ctrl.get_transactions(99999).empty());
 }
+
+TEST_CASE("delete_transaction patches the wallet balance without a reload", "[controller][transactions]") {
+    // The controller applies the new balance returned by storage to state.wallet directly,
+    // so the UI sees it immediately without re-reading the accounts table.
+    Storage store(":memory:");
+    App_state state;
+    Controller ctrl(state, store);
+
+    Account acc("Checking", Account_type::checking, 2000, true);
+    ctrl.create_account(acc);
+    int account_id = state.wallet[0].account_id;
+
+    Transaction_info trans = create_transaction_info(
+        account_id, -500, Transaction_type::Want,
+        Transaction_category_need::Other, Transaction_category_want::Shopping,
+        "Shoes", "", 2000, 1500);
+    ctrl.create_transaction(account_id, trans);
+    REQUIRE(state.wallet[0].money_amount == 1500);
+
+    ctrl.delete_transaction(ctrl.get_transactions(account_id)[0].transaction_id, account_id);
+    REQUIRE(state.wallet[0].money_amount == 2000);
+    REQUIRE(ctrl.get_transactions(account_id).empty());
+}
+
+TEST_CASE("create_transactions_batch stores all rows and patches the wallet balance", "[controller][batch]") {
+    // The bulk import path goes through the controller so state.wallet shows the final balance.
+    Storage store(":memory:");
+    App_state state;
+    Controller ctrl(state, store);
+
+    Account acc("Checking", Account_type::checking, 0, true);
+    ctrl.create_account(acc);
+    int account_id = state.wallet[0].account_id;
+
+    std::vector<Transaction_info> batch;
+    for (int i = 0; i < 10; ++i) {
+        batch.push_back(create_transaction_info(
+            account_id, 150, Transaction_type::Income,
+            Transaction_category_need::Other, Transaction_category_want::Other,
+            "Import", "", 0, 0));
+    }
+    ctrl.create_transactions_batch(account_id, batch);
+
+    REQUIRE(ctrl.get_transactions(account_id).size() == 10u);
+    REQUIRE(state.wallet[0].money_amount == 1500);
+}
+
+TEST_CASE("writes patch state.wallet from their change-sets without re-reading the accounts table", "[controller][accounts]") {
+    // Every write action applies what storage reports it changed; none of them may fall back to
+    // load_accounts, so the full-table SELECT never runs.
+    Storage store(":memory:");
+    App_state state;
+    Controller ctrl(state, store);
+
+    auto accounts_table_reads = [&store]() {
+        int reads = 0;
+        for (const Statement_stats& stats : store.get_statement_stats())
+            if (stats.sql == "SELECT * FROM accounts;")
+                reads += stats.prepare_count + stats.hit_count;
+        return reads;
+    };
+
+    Account checking("Checking", Account_type::checking, 10000, true);
+    ctrl.create_account(checking);
+    Account savings("Savings", Account_type::savings, 500, true);
+    ctrl.create_account(savings);
+    int checking_id = checking.read_account_id_in_DB();
+    int savings_id = savings.read_account_id_in_DB();
+
+    Transaction_info pay = create_transaction_info(
+        checking_id, 4000, Transaction_type::Income,
+        Transaction_category_need::Other, Transaction_category_want::Other,
+        "Pay", "", 10000, 14000);
+    ctrl.create_transaction(checking_id, pay);
+
+    Transaction_info move = create_transaction_info(
+        checking_id, 1000, Transaction_type::Internal_transfer,
+        Transaction_category_need::Other, Transaction_category_want::Other,
+        "To savings", "", 0, 0);
+    ctrl.create_internal_transfer(checking_id, savings_id, move);
+    REQUIRE(state.wallet[0].money_amount == 13000);
+    REQUIRE(state.wallet[1].money_amount == 1500);
+
+    ctrl.delete_transaction(pay.transaction_id, checking_id);
+    REQUIRE(state.wallet[0].money_amount == 9000);
+
+    ctrl.modify_account(savings_id, "Rainy day", Account_type::savings, 1500, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    REQUIRE(state.wallet[1].account_name == "Rainy day");
+    REQUIRE(state.wallet[1].initial_money_amount == 500);
+
+    ctrl.delete_account(checking_id);
+    REQUIRE(state.wallet.size() == 1u);
+    REQUIRE(state.wallet[0].account_id == savings_id);
+    REQUIRE(accounts_table_reads() == 0);
+
+    std::vector<Account_info> on_disk = store.load_accounts();
+    REQUIRE(on_disk.size() == 1u);
+    REQUIRE(on_disk[0].money_amount == state.wallet[0].money_amount);
+    REQUIRE(on_disk[0].account_name == state.wallet[0].account_name);
+}
+
+TEST_CASE("controller writes ask the idle render loop for a redraw", "[controller][frame_pacing]") {
+    // The main loop sleeps until something is dirty; a write that changes what the panels show
+    // must raise the redraw request, or the change would only appear on the next input event.
+    Storage store(":memory:");
+    App_state state;
+    Controller ctrl(state, store);
+    REQUIRE_FALSE(state.frame_pacing.dirty());
+
+    Account acc("Checking", Account_type::checking, 10000, true);
+    ctrl.create_account(acc);
+    REQUIRE(state.frame_pacing.redraw_frames == Frame_pacing::settle_frames);
+
+    state.frame_pacing.redraw_frames = 0;
+    int account_id = acc.read_account_id_in_DB();
+    Transaction_info pay = create_transaction_info(
+        account_id, 2500, Transaction_type::Income,
+        Transaction_category_need::Other, Transaction_category_want::Other,
+        "Pay", "", 10000, 12500);
+    ctrl.create_transaction(account_id, pay);
+    REQUIRE(state.frame_pacing.dirty());
+
+    state.frame_pacing.redraw_frames = 0;
+    ctrl.delete_transaction(pay.transaction_id, account_id);
+    REQUIRE(state.frame_pacing.dirty());
+}
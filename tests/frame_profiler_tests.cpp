@@ -0,0 +1,155 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/frame_profiler.h"
+#include "../src/storage.h"
+#include "../src/core_logic.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// Frame_profiler tests: sections, allocation and SQL counts land in the frame that was open when
+// they happened, and the history keeps the most recent frames in order.
+
+namespace
+{
+    long long fake_allocations = 0;
+    long long fake_allocation_count() { return fake_allocations; }
+}
+
+TEST_CASE("Frame_profiler records nested sections with their depth and adds up repeats", "[profiler]") {
+    // A panel drawn twice in one frame should show as one entry with two calls, and a section
+    // opened inside another is one level deeper.
+    Frame_profiler profiler;
+    profiler.begin_frame();
+    {
+        Profile_scope outer(&profiler, "draw_right_panel");
+        for (int i = 0; i < 2; ++i)
+            Profile_scope inner(&profiler, "draw_table");
+    }
+    profiler.end_frame();
+
+    REQUIRE(profiler.history_size() == 1u);
+    const Frame_profile& f = profiler.frame(0);
+    REQUIRE(f.section_count == 2u);
+    REQUIRE(std::strcmp(f.sections[0].name, "draw_right_panel") == 0);
+    REQUIRE(f.sections[0].depth == 0);
+    REQUIRE(f.sections[0].calls == 1);
+    REQUIRE(std::strcmp(f.sections[1].name, "draw_table") == 0);
+    REQUIRE(f.sections[1].depth == 1);
+    REQUIRE(f.sections[1].calls == 2);
+    REQUIRE(f.sections[0].ms >= f.sections[1].ms);
+    REQUIRE(f.frame_ms >= f.sections[0].ms);
+}
+
+TEST_CASE("Frame_profiler ignores sections outside a frame and keeps the latest history", "[profiler]") {
+    // Work outside begin_frame/end_frame is not attributed to any frame, and once the ring buffer
+    // is full the oldest frames drop out while frame(0) stays the oldest kept.
+    Frame_profiler profiler(3);
+    {
+        Profile_scope outside(&profiler, "outside");
+    }
+    Profile_scope null_profiler(nullptr, "records nothing");
+    for (int i = 0; i < 5; ++i) {
+        profiler.begin_frame();
+        profiler.end_frame();
+    }
+
+    REQUIRE(profiler.frames_recorded() == 5);
+    REQUIRE(profiler.history_size() == 3u);
+    REQUIRE(profiler.frame(0).frame_number == 3);
+    REQUIRE(profiler.frame(2).frame_number == 5);
+    REQUIRE(profiler.frame(2).section_count == 0u);
+}
+
+TEST_CASE("Frame_profiler counts allocations per frame through the installed counter", "[profiler]") {
+    // The count is the counter's difference across the frame; without a counter frames report 0.
+    Frame_profiler profiler;
+    profiler.begin_frame();
+    profiler.end_frame();
+    REQUIRE(profiler.frame(0).allocations == 0);
+
+    profiler.set_allocation_counter(&fake_allocation_count);
+    fake_allocations = 100;
+    profiler.begin_frame();
+    fake_allocations += 7;
+    profiler.end_frame();
+    fake_allocations += 50;   // between frames
+    REQUIRE(profiler.frame(1).allocations == 7);
+}
+
+TEST_CASE("Storage's statement observer reports the SQL run during a frame", "[profiler][storage]") {
+    // With the profiler installed as the observer, statements the UI connection runs inside a
+    // frame are counted and their text kept; once the observer is removed nothing more arrives.
+    Storage store(":memory:");
+    Frame_profiler profiler;
+    store.set_statement_observer(&Frame_profiler::observe_statement, &profiler);
+
+    profiler.begin_frame();
+    store.load_accounts();
+    profiler.end_frame();
+
+    const Frame_profile& f = profiler.frame(0);
+    REQUIRE(f.statement_count >= 1);
+    REQUIRE(std::string(f.statements[0].sql).find("SELECT") != std::string::npos);
+    REQUIRE(f.sql_ms >= 0.0);
+
+    store.set_statement_observer(nullptr, nullptr);
+    profiler.begin_frame();
+    store.load_accounts();
+    profiler.end_frame();
+    REQUIRE(profiler.frame(1).statement_count == 0);
+}
+
+TEST_CASE("Storage's statement observer reports pooled reads made on its own thread only", "[profiler][storage]") {
+    // The month list and summaries run on leased read connections; those the UI thread runs are
+    // part of its frame, while the same queries from another thread must not reach the profiler.
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "pbudget_profiler_readers.db";
+    for (const char* suffix : {"", "-wal", "-shm", "-journal"})
+        std::filesystem::remove(path.string() + suffix);
+    Storage store(path.string(), Storage_options::fast_interactive());
+    REQUIRE(store.effective_settings().read_connections > 0);
+    Frame_profiler profiler;
+    store.set_statement_observer(&Frame_profiler::observe_statement, &profiler);
+
+    profiler.begin_frame();
+    std::thread other([&store]() {
+        store.query_range_summary(1, 0, 86400);
+        store.get_monthly_rollups(1, 202401, 202412);
+    });
+    other.join();
+    profiler.end_frame();
+    REQUIRE(profiler.frame(0).statement_count == 0);
+
+    profiler.begin_frame();
+    store.query_range_summary(1, 0, 86400);
+    profiler.end_frame();
+    REQUIRE(profiler.frame(1).statement_count == 1);
+    REQUIRE(std::string(profiler.frame(1).statements[0].sql).find("SUM(CASE") != std::string::npos);
+
+    store.set_statement_observer(nullptr, nullptr);
+}
+
+TEST_CASE("Frame_profiler::dump writes every kept frame with its sections", "[profiler]") {
+    // The dump is what gets attached to a performance report, so it must carry section names and
+    // the SQL of each frame.
+    Frame_profiler profiler;
+    for (int i = 0; i < 2; ++i) {
+        profiler.begin_frame();
+        Profile_scope scope(&profiler, "draw_sidebar");
+        profiler.record_statement("SELECT 1", 0.25);
+        profiler.end_frame();   // closes the scope's section; its destructor then records nothing
+    }
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "pbudget_profile_dump.txt";
+    REQUIRE(profiler.dump(path.string()));
+    std::ifstream file(path);
+    std::stringstream text;
+    text << file.rdbuf();
+    REQUIRE(text.str().find("frame 1:") != std::string::npos);
+    REQUIRE(text.str().find("frame 2:") != std::string::npos);
+    REQUIRE(text.str().find("draw_sidebar") != std::string::npos);
+    REQUIRE(text.str().find("SELECT 1") != std::string::npos);
+    std::filesystem::remove(path);
+}
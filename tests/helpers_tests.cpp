@@ -257,3 +257,22 @@ TEST_CASE("create_transaction_info handles empty and minimal inputs", "[helpers]
     REQUIRE(info.ymd != 0);
 }
 
+
+TEST_CASE("year_month_from_time encodes local year and month as YYYYMM", "[helpers][storage]") {
+    // monthly_rollups is keyed by this value, so it must agree with the local-time month the UI shows.
+    std::time_t mid_jan_2024 = 1705320000;  // 2024-01-15 12:00 UTC, mid-month in every timezone
+    std::time_t mid_dec_2023 = 1702641600;  // 2023-12-15 12:00 UTC
+    REQUIRE(year_month_from_time(mid_jan_2024) == 202401);
+    REQUIRE(year_month_from_time(mid_dec_2023) == 202312);
+}
+
+TEST_CASE("time_from_year_month is the local start of the month year_month_from_time names", "[helpers][storage]") {
+    // The monthly summary cache only serves ranges whose ends are these month starts, so the two
+    // helpers must round-trip and land exactly on the boundary.
+    for (int year_month : {202312, 202401, 202402, 202403, 202410}) {
+        std::time_t start = time_from_year_month(year_month);
+        REQUIRE(year_month_from_time(start) == year_month);
+        REQUIRE(year_month_from_time(start - 1) != year_month);
+    }
+    REQUIRE(year_month_from_time(time_from_year_month(202413)) == 202501);
+}
@@ -4,6 +4,11 @@
 #include "../src/helpers.h"
 #include <ctime>
 #include <cmath>
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
 
 // Layer 3: Storage integration tests. Each test uses an in-memory DB (":memory:") so
 // runs are isolated and do not touch mydata.db.
@@ -144,7 +149,7 @@ TEST_CASE("load_transactions after save reflects DB state", "[storage][transacti
     store.save_transaction_info(account_id, trans);
 
     store.load_transactions(account_id);
-    const std::vector<Transaction_info>& list = store.get_transactions(account_id);
+    const Account_transactions& list = store.get_transactions(account_id);
     REQUIRE(list.size() == 1u);
     REQUIRE(list[0].transaction_amount == 5000);
     REQUIRE(list[0].transaction_name == "Salary");
@@ -181,7 +186,7 @@ TEST_CASE("delete_transaction removes row and recalculates account balance", "[s
     int id_to_delete = store.get_transactions(account_id)[1].transaction_id;
     store.delete_transaction(id_to_delete, account_id);
 
-    const std::vector<Transaction_info>& list = store.get_transactions(account_id);
+    const Account_transactions& list = store.get_transactions(account_id);
     REQUIRE(list.size() == 1u);
     std::vector<Account_info> loaded = store.load_accounts();
     REQUIRE(loaded[0].money_amount == 10000);
@@ -261,6 +266,75 @@ TEST_CASE("get_specific_range_of_transactions_info sets money_remaining to zero
     REQUIRE(info.money_remaining == 0);
 }
 
+TEST_CASE("Range summaries keep totals above INT_MAX", "[storage][summary]") {
+    // Each amount fits an int but a month's totals do not; every summary path (SQL, the month
+    // cache once patched, and the in-memory running totals) must return the full 64-bit sums.
+    Storage store(":memory:");
+    Account acc("Checking", Account_type::checking, 0, true);
+    store.save_account_info(acc);
+    int account_id = acc.read_account_id_in_DB();
+    std::time_t jan_1 = time_from_year_month(202401);
+    std::time_t feb_1 = time_from_year_month(202402);
+
+    auto save = [&](int amount, int hour) {
+        Transaction_info t = create_transaction_info(
+            account_id, amount, amount > 0 ? Transaction_type::Income : Transaction_type::Need,
+            Transaction_category_need::Other, Transaction_category_want::Other,
+            "Large", "", 0, 0);
+        t.ymd = jan_1 + hour * 3600;
+        store.save_transaction_info(account_id, t);
+    };
+    const std::int64_t billion = 1000000000;
+    save(1000000000, 1);
+    save(-1000000000, 2);
+    save(1000000000, 3);
+    REQUIRE(store.get_range_summary(account_id, jan_1, feb_1).money_in == 2 * billion);   // month now cached
+    save(-1000000000, 4);
+    save(1000000000, 5);
+
+    specific_range_of_transactions_info from_sql = store.query_range_summary(account_id, jan_1, feb_1);
+    specific_range_of_transactions_info from_cache = store.get_range_summary(account_id, jan_1, feb_1);
+    for (const specific_range_of_transactions_info& info : {from_sql, from_cache}) {
+        REQUIRE(info.money_in == 3 * billion);
+        REQUIRE(info.money_out == 2 * billion);
+        REQUIRE(info.money_remaining == billion);
+    }
+
+    store.load_all_transactions();
+    specific_range_of_transactions_info from_memory = store.get_range_summary(account_id, jan_1, feb_1);
+    REQUIRE(from_memory.money_in == 3 * billion);
+    REQUIRE(from_memory.money_out == 2 * billion);
+    REQUIRE(from_memory.money_remaining == billion);
+}
+
+TEST_CASE("a Storage with cache_writes off commits without keeping the rows", "[storage][transactions]") {
+    // The pipeline's writer only writes: its change-sets go to the UI Storage, so it must not
+    // build a second in-memory copy of every row, while the database and the change-set are as usual.
+    Storage_options options;
+    options.cache_writes = false;
+    Storage writer(":memory:", options);
+    Account acc("Checking", Account_type::checking, 1000, true);
+    writer.save_account_info(acc);
+    int account_id = acc.read_account_id_in_DB();
+
+    std::optional<Storage_changes> changes = writer.save_transaction_info(account_id, create_transaction_info(
+        account_id, -300, Transaction_type::Need,
+        Transaction_category_need::Food, Transaction_category_want::Other,
+        "Lunch", "", 1000, 700));
+    REQUIRE(changes.has_value());
+    REQUIRE(changes->inserted.size() == 1u);
+    REQUIRE(changes->balance_of(account_id) == 700);
+    REQUIRE(writer.get_transactions(account_id).empty());
+
+    Storage ui(":memory:");
+    ui.apply_changes(*changes);
+    REQUIRE(ui.get_transactions(account_id).size() == 1u);
+
+    writer.load_transactions(account_id);   // explicit loads still fill the cache
+    REQUIRE(writer.get_transactions(account_id).size() == 1u);
+    REQUIRE(writer.load_accounts()[0].money_amount == 700);
+}
+
 TEST_CASE("save_internal_transfer creates two entries and updates both account balances", "[storage][transfer]") {
     // Ensures an internal transfer inserts one transaction row per account with correct signed
     // amounts and updates both account balances so the books stay balanced and both sides are visible.
@@ -280,8 +354,8 @@ TEST_CASE("save_internal_transfer creates two entries and updates both account b
 
     store.load_transactions(from_id);
     store.load_transactions(to_id);
-    const std::vector<Transaction_info>& from_list = store.get_transactions(from_id);
-    const std::vector<Transaction_info>& to_list = store.get_transactions(to_id);
+    const Account_transactions& from_list = store.get_transactions(from_id);
+    const Account_transactions& to_list = store.get_transactions(to_id);
     REQUIRE(from_list.size() == 1u);
     REQUIRE(to_list.size() == 1u);
     REQUIRE(from_list[0].transaction_amount == -3000);
@@ -296,3 +370,751 @@ TEST_CASE("save_internal_transfer creates two entries and updates both account b
     REQUIRE(from_balance == 7000);
     REQUIRE(to_balance == 5000);
 }
+
+TEST_CASE("repeated writes reuse cached prepared statements", "[storage][statements]") {
+    // Guards the statement cache: saving many transactions must prepare each SQL string once
+    // and then only reset/rebind it, so SQL parsing never shows up on the hot write path.
+    Storage store(":memory:");
+    Account acc("Checking", Account_type::checking, 0, true);
+    store.save_account_info(acc);
+    int account_id = acc.read_account_id_in_DB();
+
+    const int writes = 5;
+    int balance = 0;
+    for (int i = 0; i < writes; ++i) {
+        Transaction_info trans = create_transaction_info(
+            account_id, 100, Transaction_type::Income,
+            Transaction_category_need::Other, Transaction_category_want::Other,
+            "Pay", "", balance, balance + 100);
+        store.save_transaction_info(account_id, trans);
+        balance += 100;
+    }
+
+    bool saw_insert = false;
+    for (const Statement_stats& stats : store.get_statement_stats()) {
+        REQUIRE(stats.prepare_count == 1);
+        if (stats.sql.find("INSERT INTO transactions_table") != std::string::npos) {
+            saw_insert = true;
+            REQUIRE(stats.hit_count == writes - 1);
+        }
+    }
+    REQUIRE(saw_insert);
+}
+
+TEST_CASE("get_range_summary is cached and kept current by writes", "[storage][summary]") {
+    // The per-frame monthly summary must not hit SQL once cached, yet it has to reflect
+    // new and deleted transactions immediately so the UI never shows stale totals.
+    Storage store(":memory:");
+    Account acc("Checking", Account_type::checking, 0, true);
+    store.save_account_info(acc);
+    int account_id = acc.read_account_id_in_DB();
+
+    std::time_t jan_1 = time_from_year_month(202401);
+    std::time_t feb_1 = time_from_year_month(202402);
+
+    Transaction_info t1 = create_transaction_info(
+        account_id, 5000, Transaction_type::Income,
+        Transaction_category_need::Other, Transaction_category_want::Other,
+        "Pay", "", 0, 5000);
+    t1.ymd = jan_1 + 3600;
+    store.save_transaction_info(account_id, t1);
+
+    specific_range_of_transactions_info first = store.get_range_summary(account_id, jan_1, feb_1);
+    REQUIRE(first.money_in == 5000);
+    REQUIRE(first.money_out == 0);
+
+    auto summary_hits = [&store]() {
+        for (const Statement_stats& stats : store.get_statement_stats())
+            if (stats.sql.find("SUM(CASE") != std::string::npos)
+                return stats.prepare_count + stats.hit_count;
+        return 0;
+    };
+    const int queries_after_first = summary_hits();
+
+    Transaction_info t2 = create_transaction_info(
+        account_id, -1500, Transaction_type::Need,
+        Transaction_category_need::Food, Transaction_category_want::Other,
+        "Food", "", 5000, 3500);
+    t2.ymd = jan_1 + 7200;
+    store.save_transaction_info(account_id, t2);
+
+    Transaction_info t3 = create_transaction_info(
+        account_id, -700, Transaction_type::Need,
+        Transaction_category_need::Food, Transaction_category_want::Other,
+        "Next month", "", 3500, 2800);
+    t3.ymd = feb_1 + 3600;
+    store.save_transaction_info(account_id, t3);
+
+    specific_range_of_transactions_info after_insert = store.get_range_summary(account_id, jan_1, feb_1);
+    REQUIRE(after_insert.money_in == 5000);
+    REQUIRE(after_insert.money_out == 1500);
+    REQUIRE(after_insert.money_remaining == 3500);
+
+    store.delete_transaction(t1.transaction_id, account_id);
+    specific_range_of_transactions_info after_delete = store.get_range_summary(account_id, jan_1, feb_1);
+    REQUIRE(after_delete.money_in == 0);
+    REQUIRE(after_delete.money_out == 1500);
+    REQUIRE(after_delete.money_remaining == 0);
+
+    REQUIRE(summary_hits() == queries_after_first);
+}
+
+TEST_CASE("get_range_summary keeps one entry per month and queries other ranges each time", "[storage][summary]") {
+    // Whole-month ranges add up per-month entries, so a quarter reuses the months already shown;
+    // a range that does not start and end on month boundaries goes to SQL and is not kept.
+    Storage store(":memory:");
+    Account acc("Checking", Account_type::checking, 0, true);
+    store.save_account_info(acc);
+    int account_id = acc.read_account_id_in_DB();
+
+    const int months[] = {202411, 202412, 202501};
+    for (int i = 0; i < 3; ++i) {
+        Transaction_info trans = create_transaction_info(
+            account_id, (i + 1) * 1000, Transaction_type::Income,
+            Transaction_category_need::Other, Transaction_category_want::Other,
+            "Pay", "", 0, 0);
+        trans.ymd = time_from_year_month(months[i]) + 86400;
+        store.save_transaction_info(account_id, trans);
+    }
+
+    auto summary_queries = [&store]() {
+        for (const Statement_stats& stats : store.get_statement_stats())
+            if (stats.sql.find("SUM(CASE") != std::string::npos)
+                return stats.prepare_count + stats.hit_count;
+        return 0;
+    };
+
+    // across the year end, one query per month the first time
+    specific_range_of_transactions_info quarter = store.get_range_summary(account_id,
+        time_from_year_month(202411), time_from_year_month(202502));
+    REQUIRE(quarter.money_in == 6000);
+    REQUIRE(summary_queries() == 3);
+    REQUIRE(store.get_range_summary(account_id, time_from_year_month(202412), time_from_year_month(202501)).money_in == 2000);
+    REQUIRE(summary_queries() == 3);
+
+    // a write lands in its own month's entry
+    Transaction_info late = create_transaction_info(
+        account_id, -400, Transaction_type::Need,
+        Transaction_category_need::Food, Transaction_category_want::Other,
+        "Food", "", 0, 0);
+    late.ymd = time_from_year_month(202412) + 2 * 86400;
+    store.save_transaction_info(account_id, late);
+    quarter = store.get_range_summary(account_id, time_from_year_month(202411), time_from_year_month(202502));
+    REQUIRE(quarter.money_in == 6000);
+    REQUIRE(quarter.money_out == 400);
+    REQUIRE(summary_queries() == 3);
+
+    std::time_t mid_december = time_from_year_month(202412) + 86400 / 2;
+    for (int i = 0; i < 2; ++i)
+        REQUIRE(store.get_range_summary(account_id, mid_december, time_from_year_month(202501)).money_in == 2000);
+    REQUIRE(summary_queries() == 5);
+}
+
+TEST_CASE("get_balance_at rewinds the current balance past later transactions", "[storage][balance]") {
+    // Historical balances come from today's balance minus everything dated at or after the
+    // asked-for time, so back-dated rows count by date, not by insertion order. The SQL path
+    // (before load_all_transactions) and the cached path must agree.
+    std::string path = std::filesystem::temp_directory_path() / "pbudget_balance_at.db";
+    std::filesystem::remove(path);
+    const std::time_t jan_1 = 1704067200;
+    const std::time_t day = 86400;
+    int account_id = 0;
+    {
+        Storage store(path);
+        Account acc("Checking", Account_type::checking, 10000, true);
+        store.save_account_info(acc);
+        account_id = acc.read_account_id_in_DB();
+        int balance = 10000;
+        for (auto [amount, ymd] : {std::pair{-2000, jan_1 + 10 * day}, std::pair{5000, jan_1 + 40 * day}, std::pair{-700, jan_1 + 5 * day}}) {
+            Transaction_info trans = create_transaction_info(
+                account_id, amount, amount > 0 ? Transaction_type::Income : Transaction_type::Need,
+                Transaction_category_need::Food, Transaction_category_want::Other, "Row", "", balance, balance + amount);
+            trans.ymd = ymd;
+            balance += amount;
+            REQUIRE(store.save_transaction_info(account_id, trans));
+        }
+    }
+
+    std::vector<std::time_t> times = {jan_1, jan_1 + 6 * day, jan_1 + 10 * day, jan_1 + 11 * day, jan_1 + 100 * day};
+    std::vector<std::int64_t> expected = {10000, 9300, 9300, 7300, 12300};
+
+    Storage store(path);
+    REQUIRE(store.get_balances_at(account_id, times) == expected);
+    REQUIRE_FALSE(store.get_balance_at(account_id + 1, jan_1).has_value());
+
+    store.load_accounts();
+    store.load_all_transactions();
+    REQUIRE(store.get_balances_at(account_id, times) == expected);
+
+    int first_id = store.get_transactions(account_id)[0].transaction_id;
+    store.delete_transaction(first_id, account_id);
+    REQUIRE(*store.get_balance_at(account_id, jan_1 + 100 * day) == 14300);
+    REQUIRE(*store.get_balance_at(account_id, jan_1 + 11 * day) == 9300);
+}
+
+TEST_CASE("get_range_summary answers any range from the date index once everything is loaded", "[storage][summary]") {
+    // After load_all_transactions, monthly, yearly and custom ranges come from the cached rows,
+    // including back-dated inserts and deletes, and agree with the SQL aggregate.
+    Storage store(":memory:");
+    Account acc("Checking", Account_type::checking, 0, true);
+    store.save_account_info(acc);
+    int account_id = acc.read_account_id_in_DB();
+    store.load_all_transactions();
+
+    const std::time_t jan_1 = 1704067200;
+    const std::time_t day = 86400;
+    auto save = [&](int amount, std::time_t ymd) {
+        Transaction_info trans = create_transaction_info(
+            account_id, amount, amount > 0 ? Transaction_type::Income : Transaction_type::Need,
+            Transaction_category_need::Food, Transaction_category_want::Other, "Row", "", 0, 0);
+        trans.ymd = ymd;
+        store.save_transaction_info(account_id, trans);
+        return trans.transaction_id;
+    };
+    save(5000, jan_1 + 40 * day);
+    save(-1200, jan_1 + 200 * day);
+    int back_dated = save(-300, jan_1 + 2 * day);
+    save(700, jan_1 + 400 * day);
+
+    auto summary_queries = [&store]() {
+        for (const Statement_stats& stats : store.get_statement_stats())
+            if (stats.sql.find("SUM(CASE") != std::string::npos)
+                return stats.prepare_count + stats.hit_count;
+        return 0;
+    };
+
+    std::time_t year_end = jan_1 + 366 * day;
+    specific_range_of_transactions_info year = store.get_range_summary(account_id, jan_1, year_end);
+    REQUIRE(year.money_in == 5000);
+    REQUIRE(year.money_out == 1500);
+    REQUIRE(year.money_remaining == 3500);
+
+    std::vector<int> ids;
+    for (const auto& t : store.get_transactions_in_range(account_id, jan_1, year_end))
+        ids.push_back(t.transaction_id);
+    REQUIRE(ids.size() == 3u);
+    REQUIRE(ids.front() == back_dated);
+
+    store.delete_transaction(back_dated, account_id);
+    specific_range_of_transactions_info custom = store.get_range_summary(account_id, jan_1, jan_1 + 100 * day);
+    REQUIRE(custom.money_in == 5000);
+    REQUIRE(custom.money_out == 0);
+    REQUIRE(store.get_range_summary(account_id, jan_1, year_end).money_out == 1200);
+    REQUIRE(summary_queries() == 0);
+
+    specific_range_of_transactions_info from_sql = store.query_range_summary(account_id, jan_1, jan_1 + 500 * day);
+    specific_range_of_transactions_info from_cache = store.get_range_summary(account_id, jan_1, jan_1 + 500 * day);
+    REQUIRE(from_cache.money_in == from_sql.money_in);
+    REQUIRE(from_cache.money_out == from_sql.money_out);
+}
+
+namespace {
+    // Migration and query-plan tests need a real file so a second connection can inspect it.
+    std::string fresh_db_path(const char* name) {
+        std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+        for (const char* suffix : {"", "-wal", "-shm", "-journal"})
+            std::filesystem::remove(path.string() + suffix);
+        return path.string();
+    }
+
+    std::string query_plan(sqlite3* db, const char* sql) {
+        std::string plan;
+        sqlite3_stmt* stmt = nullptr;
+        std::string explain = std::string("EXPLAIN QUERY PLAN ") + sql;
+        REQUIRE(sqlite3_prepare_v2(db, explain.c_str(), -1, &stmt, nullptr) == SQLITE_OK);
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+            plan += reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)) + std::string("\n");
+        sqlite3_finalize(stmt);
+        return plan;
+    }
+}
+
+TEST_CASE("new databases are created at the latest schema version", "[storage][schema]") {
+    // A fresh database must run every migration so user_version matches the code and the
+    // next start-up does not try to migrate again.
+    Storage store(":memory:");
+    REQUIRE(store.schema_version() == Storage::latest_schema_version());
+}
+
+TEST_CASE("migrations upgrade an old database in place", "[storage][schema]") {
+    // Early builds wrote a 4-column accounts table, no transaction_category and no indexes.
+    // Opening such a file must add the missing columns, keep existing rows and bump user_version.
+    std::string path = fresh_db_path("pbudget_migration_test.db");
+    {
+        sqlite3* old_db = nullptr;
+        REQUIRE(sqlite3_open(path.c_str(), &old_db) == SQLITE_OK);
+        REQUIRE(sqlite3_exec(old_db,
+            "CREATE TABLE accounts(id INTEGER PRIMARY KEY, money_amount INTEGER, account_name TEXT, account_type TEXT);"
+            "CREATE TABLE transactions_table(id INTEGER PRIMARY KEY, account_id INTEGER, transaction_amount INTEGER,"
+            " transaction_type TEXT, previous_amount INTEGER, new_amount INTEGER, transaction_date INTEGER,"
+            " transaction_name TEXT, note TEXT);"
+            "INSERT INTO accounts VALUES(1, 2500, 'Legacy', 'Checking');"
+            "INSERT INTO transactions_table VALUES(1, 1, 2500, 'Income', 0, 2500, 1704067200, 'Old pay', '');",
+            nullptr, nullptr, nullptr) == SQLITE_OK);
+        sqlite3_close(old_db);
+    }
+
+    {
+        Storage store(path);
+        REQUIRE(store.schema_version() == Storage::latest_schema_version());
+
+        std::vector<Account_info> loaded = store.load_accounts();
+        REQUIRE(loaded.size() == 1u);
+        REQUIRE(loaded[0].account_name == "Legacy");
+        REQUIRE(loaded[0].money_amount == 2500);
+        REQUIRE(loaded[0].is_asset == true);
+
+        store.load_all_transactions();
+        REQUIRE(store.get_transactions(1).size() == 1u);
+        REQUIRE(store.get_transactions(1)[0].transaction_name == "Old pay");
+
+        std::vector<Monthly_rollup> rollups = store.get_monthly_rollups(1, 190001, 299912);
+        REQUIRE(rollups.size() == 1u);
+        REQUIRE(rollups[0].money_in == 2500);
+        REQUIRE(rollups[0].txn_count == 1);
+    }
+
+    // Re-opening an up-to-date file is a no-op.
+    Storage reopened(path);
+    REQUIRE(reopened.schema_version() == Storage::latest_schema_version());
+}
+
+TEST_CASE("per-account transaction queries use the account/date index", "[storage][schema]") {
+    // The plans are taken from the SQL Storage actually prepared while running its per-account
+    // read paths, so an edited query is checked as written. None may scan a table, and the
+    // aggregates must be answered from the covering index without touching table rows.
+    std::string path = fresh_db_path("pbudget_query_plan_test.db");
+    Storage store(path);
+    Account acc("Checking", Account_type::checking, 0, true);
+    store.save_account_info(acc);
+    int account_id = acc.read_account_id_in_DB();
+
+    std::time_t jan_1 = time_from_year_month(202401);
+    std::time_t feb_1 = time_from_year_month(202402);
+    for (Transaction_columns columns : {Transaction_columns::summary, Transaction_columns::list, Transaction_columns::full})
+        store.get_monthly_information(account_id, jan_1, feb_1, columns);
+    store.query_range_summary(account_id, jan_1, feb_1);
+    store.get_balance_at(account_id, jan_1);
+    std::time_t times[] = {jan_1, feb_1};
+    store.get_balances_at(account_id, times);
+    store.get_monthly_rollups(account_id, 202401, 202412);
+    store.load_transactions(account_id);
+
+    sqlite3* db = nullptr;
+    REQUIRE(sqlite3_open(path.c_str(), &db) == SQLITE_OK);
+    int checked = 0;
+    int aggregates = 0;
+    for (const Statement_stats& stats : store.get_statement_stats()) {
+        const std::string& sql = stats.sql;
+        if (sql.rfind("SELECT", 0) != 0 || sql.find("account_id = ") == std::string::npos)
+            continue;
+        std::string plan = query_plan(db, sql.c_str());
+        INFO(sql << "\n" << plan);
+        REQUIRE(plan.find("SCAN ") == std::string::npos);
+        if (sql.find("transactions_table") != std::string::npos)
+            REQUIRE(plan.find("idx_transactions_account_date") != std::string::npos);
+        if (sql.find("SUM(") != std::string::npos) {
+            REQUIRE(plan.find("USING COVERING INDEX idx_transactions_account_date") != std::string::npos);
+            ++aggregates;
+        }
+        ++checked;
+    }
+    sqlite3_close(db);
+
+    // three column sets, the range summary, both balance queries, rollups and the account reload
+    REQUIRE(checked >= 8);
+    REQUIRE(aggregates >= 2);
+}
+
+TEST_CASE("monthly_rollups follow saves, transfers and deletes and can be rebuilt", "[storage][rollups]") {
+    // The rollup table is only useful if it always agrees with the raw rows: every write path
+    // must adjust it in the same transaction, and rebuild_monthly_rollups must repair drift.
+    std::string path = fresh_db_path("pbudget_rollup_test.db");
+    Storage store(path);
+    Account acc("Checking", Account_type::checking, 0, true);
+    Account other("Savings", Account_type::savings, 0, true);
+    store.save_account_info(acc);
+    store.save_account_info(other);
+    int account_id = acc.read_account_id_in_DB();
+    int other_id = other.read_account_id_in_DB();
+
+    std::time_t mid_jan = 1705320000;  // 2024-01-15 12:00 UTC
+    std::time_t mid_feb = 1707998400;  // 2024-02-15 12:00 UTC
+
+    Transaction_info pay = create_transaction_info(
+        account_id, 5000, Transaction_type::Income,
+        Transaction_category_need::Other, Transaction_category_want::Other,
+        "Pay", "", 0, 5000);
+    pay.ymd = mid_jan;
+    store.save_transaction_info(account_id, pay);
+
+    Transaction_info food = create_transaction_info(
+        account_id, -1200, Transaction_type::Need,
+        Transaction_category_need::Food, Transaction_category_want::Other,
+        "Food", "", 5000, 3800);
+    food.ymd = mid_jan + 3600;
+    store.save_transaction_info(account_id, food);
+
+    Transaction_info move = create_transaction_info(
+        account_id, 800, Transaction_type::Internal_transfer,
+        Transaction_category_need::Other, Transaction_category_want::Other,
+        "Move", "", 3800, 3000);
+    move.ymd = mid_feb;
+    store.save_internal_transfer(account_id, other_id, move);
+
+    std::vector<Monthly_rollup> rollups = store.get_monthly_rollups(account_id, 202401, 202412);
+    REQUIRE(rollups.size() == 2u);
+    REQUIRE(rollups[0].year_month == 202401);
+    REQUIRE(rollups[0].money_in == 5000);
+    REQUIRE(rollups[0].money_out == 1200);
+    REQUIRE(rollups[0].txn_count == 2);
+    REQUIRE(rollups[1].year_month == 202402);
+    REQUIRE(rollups[1].money_out == 800);
+
+    std::vector<Monthly_rollup> other_rollups = store.get_monthly_rollups(other_id, 202401, 202412);
+    REQUIRE(other_rollups.size() == 1u);
+    REQUIRE(other_rollups[0].money_in == 800);
+
+    store.delete_transaction(food.transaction_id, account_id);
+    rollups = store.get_monthly_rollups(account_id, 202401, 202401);
+    REQUIRE(rollups.size() == 1u);
+    REQUIRE(rollups[0].money_out == 0);
+    REQUIRE(rollups[0].txn_count == 1);
+
+    // Corrupt the table behind Storage's back, then repair it from the raw rows.
+    sqlite3* db = nullptr;
+    REQUIRE(sqlite3_open(path.c_str(), &db) == SQLITE_OK);
+    REQUIRE(sqlite3_exec(db, "UPDATE monthly_rollups SET money_in = 1, txn_count = 9;", nullptr, nullptr, nullptr) == SQLITE_OK);
+    sqlite3_close(db);
+
+    REQUIRE(store.rebuild_monthly_rollups());
+    rollups = store.get_monthly_rollups(account_id, 202401, 202412);
+    REQUIRE(rollups.size() == 2u);
+    REQUIRE(rollups[0].money_in == 5000);
+    REQUIRE(rollups[0].txn_count == 1);
+    REQUIRE(rollups[1].money_out == 800);
+    REQUIRE(rollups[1].txn_count == 1);
+}
+
+TEST_CASE("delete_account rolls back every table when one of its deletes fails", "[storage][accounts]") {
+    // The account, its rows and its rollups are deleted in one transaction. A trigger makes the
+    // last DELETE fail; the account and its transactions must still be there, in the database and
+    // in the cache, rather than half removed.
+    std::string path = fresh_db_path("pbudget_delete_account_rollback.db");
+    Storage store(path);
+    Account acc("Checking", Account_type::checking, 0, true);
+    store.save_account_info(acc);
+    int account_id = acc.read_account_id_in_DB();
+    Transaction_info pay = create_transaction_info(
+        account_id, 5000, Transaction_type::Income,
+        Transaction_category_need::Other, Transaction_category_want::Other,
+        "Pay", "", 0, 5000);
+    store.save_transaction_info(account_id, pay);
+
+    sqlite3* db = nullptr;
+    REQUIRE(sqlite3_open(path.c_str(), &db) == SQLITE_OK);
+    REQUIRE(sqlite3_exec(db, "CREATE TRIGGER fail_rollup_delete BEFORE DELETE ON monthly_rollups "
+                             "BEGIN SELECT RAISE(ABORT, 'injected failure'); END;", nullptr, nullptr, nullptr) == SQLITE_OK);
+    sqlite3_close(db);
+
+    REQUIRE_FALSE(store.delete_account(account_id).has_value());
+    REQUIRE(store.get_transactions(account_id).size() == 1u);
+
+    Storage reopened(path);
+    REQUIRE(reopened.load_accounts().size() == 1u);
+    reopened.load_all_transactions();
+    REQUIRE(reopened.get_transactions(account_id).size() == 1u);
+    REQUIRE(reopened.get_monthly_rollups(account_id, 190001, 299912).size() == 1u);
+}
+
+TEST_CASE("delete_transaction applies the removed amount as a balance delta", "[storage][transactions]") {
+    // Deletes must not rescan or reload the account: the balance moves by exactly the removed
+    // amount, only that row leaves the cache, and ids that do not belong to the account are ignored.
+    Storage store(":memory:");
+    Account acc("Checking", Account_type::checking, 1000, true);
+    store.save_account_info(acc);
+    int account_id = acc.read_account_id_in_DB();
+
+    int balance = 1000;
+    for (int amount : {500, -200, 300}) {
+        Transaction_info trans = create_transaction_info(
+            account_id, amount, amount > 0 ? Transaction_type::Income : Transaction_type::Need,
+            Transaction_category_need::Other, Transaction_category_want::Other,
+            "Row", "", balance, balance + amount);
+        store.save_transaction_info(account_id, trans);
+        balance += amount;
+    }
+    REQUIRE(balance == 1600);
+
+    int middle_id = store.get_transactions(account_id)[1].transaction_id;
+    std::optional<Storage_changes> changes = store.delete_transaction(middle_id, account_id);
+    REQUIRE(changes.has_value());
+    REQUIRE(changes->balance_of(account_id) == 1800);
+
+    const Account_transactions& list = store.get_transactions(account_id);
+    REQUIRE(list.size() == 2u);
+    REQUIRE(list[0].transaction_amount == 500);
+    REQUIRE(list[1].transaction_amount == 300);
+    REQUIRE(store.load_accounts()[0].money_amount == 1800);
+
+    REQUIRE_FALSE(store.delete_transaction(middle_id, account_id).has_value());
+    REQUIRE_FALSE(store.delete_transaction(list[0].transaction_id, account_id + 1).has_value());
+    REQUIRE(store.get_transactions(account_id).size() == 2u);
+    REQUIRE(store.load_accounts()[0].money_amount == 1800);
+}
+
+TEST_CASE("save_transactions_batch inserts rows with running balances in one transaction", "[storage][batch]") {
+    // Bulk imports compute previous/new balances in memory and write the account balance once;
+    // the result must match what the same rows would produce one at a time.
+    Storage store(":memory:");
+    Account acc("Checking", Account_type::checking, 1000, true);
+    store.save_account_info(acc);
+    int account_id = acc.read_account_id_in_DB();
+
+    std::time_t mid_jan = 1705320000;
+    std::time_t mid_feb = 1707998400;
+    std::vector<Transaction_info> batch;
+    for (int amount : {2000, -500, -300}) {
+        Transaction_info trans = create_transaction_info(
+            account_id, amount, amount > 0 ? Transaction_type::Income : Transaction_type::Need,
+            Transaction_category_need::Food, Transaction_category_want::Other,
+            "Imported", "bank export", 0, 0);
+        trans.ymd = mid_jan;
+        batch.push_back(trans);
+    }
+    batch.back().ymd = mid_feb;
+
+    std::optional<Storage_changes> changes = store.save_transactions_batch(account_id, batch);
+    REQUIRE(changes.has_value());
+    REQUIRE(changes->balance_of(account_id) == 2200);
+    REQUIRE(changes->inserted.size() == 3u);
+
+    REQUIRE(batch[0].account_previous_amount == 1000);
+    REQUIRE(batch[0].account_new_amount == 3000);
+    REQUIRE(batch[2].account_previous_amount == 2500);
+    REQUIRE(batch[2].account_new_amount == 2200);
+    REQUIRE(batch[0].transaction_id < batch[1].transaction_id);
+    REQUIRE(batch[1].transaction_id < batch[2].transaction_id);
+
+    const Account_transactions& cached = store.get_transactions(account_id);
+    REQUIRE(cached.size() == 3u);
+    REQUIRE(cached[1].transaction_amount == -500);
+    REQUIRE(cached[1].transaction_category_need == Transaction_category_need::Food);
+
+    store.load_transactions(account_id);
+    REQUIRE(store.get_transactions(account_id).size() == 3u);
+    REQUIRE(store.get_transaction_note(account_id, batch[2].transaction_id) == "bank export");
+    REQUIRE(store.load_accounts()[0].money_amount == 2200);
+
+    std::vector<Monthly_rollup> rollups = store.get_monthly_rollups(account_id, 202401, 202402);
+    REQUIRE(rollups.size() == 2u);
+    REQUIRE(rollups[0].money_in == 2000);
+    REQUIRE(rollups[0].money_out == 500);
+    REQUIRE(rollups[0].txn_count == 2);
+    REQUIRE(rollups[1].money_out == 300);
+
+    std::vector<Transaction_info> orphan(1, batch[0]);
+    REQUIRE_FALSE(store.save_transactions_batch(account_id + 100, orphan).has_value());
+    REQUIRE(store.get_transactions(account_id).size() == 3u);
+}
+
+TEST_CASE("write methods return the balances, rows and accounts they changed", "[storage][changes]") {
+    // The change-set is what callers patch their own state from, so it must match what a reload
+    // would show: new balances, committed rows with ids, removed rows, and saved or deleted accounts.
+    Storage store(":memory:");
+    Account from_acc("From", Account_type::checking, 10000, true);
+    Account to_acc("To", Account_type::savings, 0, true);
+    std::optional<Storage_changes> created = store.save_account_info(from_acc);
+    REQUIRE(created.has_value());
+    REQUIRE(created->accounts_saved.size() == 1u);
+    REQUIRE(created->accounts_saved[0].account_id == from_acc.read_account_id_in_DB());
+    store.save_account_info(to_acc);
+    int from_id = from_acc.read_account_id_in_DB();
+    int to_id = to_acc.read_account_id_in_DB();
+
+    Transaction_info trans = create_transaction_info(
+        from_id, 2500, Transaction_type::Internal_transfer,
+        Transaction_category_need::Other, Transaction_category_want::Other,
+        "Move", "", 0, 0);
+    std::optional<Storage_changes> transfer = store.save_internal_transfer(from_id, to_id, trans);
+    REQUIRE(transfer.has_value());
+    REQUIRE(transfer->balance_of(from_id) == 7500);
+    REQUIRE(transfer->balance_of(to_id) == 2500);
+    REQUIRE(transfer->inserted.size() == 2u);
+    REQUIRE(transfer->inserted[0].account_id == from_id);
+    REQUIRE(transfer->inserted[0].transaction_amount == -2500);
+    REQUIRE(transfer->inserted[1].transaction_id == store.get_transactions(to_id)[0].transaction_id);
+
+    int from_row = transfer->inserted[0].transaction_id;
+    std::optional<Storage_changes> removed = store.delete_transaction(from_row, from_id);
+    REQUIRE(removed.has_value());
+    REQUIRE(removed->balance_of(from_id) == 10000);
+    REQUIRE_FALSE(removed->balance_of(to_id).has_value());
+    REQUIRE(removed->removed.size() == 1u);
+    REQUIRE(removed->removed[0].transaction_id == from_row);
+    REQUIRE(removed->removed[0].transaction_amount == -2500);
+
+    std::optional<Storage_changes> modified = store.modify_account_in_storage(to_id, "Renamed", Account_type::savings, 2500,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    REQUIRE(modified.has_value());
+    REQUIRE(modified->accounts_saved.size() == 1u);
+    REQUIRE(modified->accounts_saved[0].account_name == "Renamed");
+    REQUIRE(modified->accounts_saved[0].initial_money_amount == 0);
+    REQUIRE_FALSE(store.modify_account_in_storage(to_id + 100, "Nobody", Account_type::savings, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).has_value());
+
+    std::optional<Storage_changes> deleted = store.delete_account(from_id);
+    REQUIRE(deleted.has_value());
+    REQUIRE(deleted->accounts_deleted.size() == 1u);
+    REQUIRE(deleted->accounts_deleted[0] == from_id);
+    REQUIRE(store.get_transactions(from_id).empty());
+}
+
+TEST_CASE("Storage_options presets take effect and are reported back", "[storage][options]") {
+    // Each deployment picks how much fsync latency it pays for crash safety; effective_settings()
+    // reads the pragmas back so the choice can be checked rather than assumed.
+    SECTION("fast_interactive switches a file database to WAL") {
+        std::string path = fresh_db_path("options_fast");
+        Storage store(path, Storage_options::fast_interactive());
+        Storage_settings settings = store.effective_settings();
+
+        REQUIRE(settings.journal_mode == "wal");
+        REQUIRE(settings.synchronous == static_cast<int>(Synchronous_mode::normal));
+        REQUIRE(settings.cache_size == -16384);
+        REQUIRE(settings.temp_store == static_cast<int>(Temp_store::memory));
+        REQUIRE(settings.busy_timeout_ms == 5000);
+
+        Account acc("Checking", Account_type::checking, 100, true);
+        store.save_account_info(acc);
+        REQUIRE(store.load_accounts().size() == 1u);
+    }
+
+    SECTION("max_durability keeps the rollback journal with synchronous=EXTRA") {
+        std::string path = fresh_db_path("options_durable");
+        Storage store(path, Storage_options::max_durability());
+        Storage_settings settings = store.effective_settings();
+
+        REQUIRE(settings.journal_mode == "delete");
+        REQUIRE(settings.synchronous == static_cast<int>(Synchronous_mode::extra));
+        REQUIRE(settings.busy_timeout_ms == 5000);
+    }
+
+    SECTION("default options leave SQLite's own defaults in place") {
+        Storage store(":memory:");
+        Storage_settings settings = store.effective_settings();
+
+        REQUIRE(settings.journal_mode == "memory");
+        REQUIRE(settings.busy_timeout_ms == 0);
+    }
+}
+
+TEST_CASE("read-only pool serves thread-safe queries while the owner keeps writing", "[storage][readers]") {
+    // Reporting threads use the pooled WAL readers; they must never see a half-applied write
+    // (the rollup and the raw rows always agree) and must not stop the owning thread's commits.
+    std::string path = fresh_db_path("pbudget_reader_pool_test.db");
+    Storage store(path, Storage_options::fast_interactive());
+    REQUIRE(store.effective_settings().read_connections == 2);
+
+    Account acc("Checking", Account_type::checking, 0, true);
+    store.save_account_info(acc);
+    int account_id = acc.read_account_id_in_DB();
+
+    std::time_t mid_month = 1705320000;
+    int year_month = year_month_from_time(mid_month);
+    std::time_t range_start = mid_month - 86400;
+    std::time_t range_end = mid_month + 86400;
+
+    const int writes = 200;
+    std::atomic<bool> done{false};
+    std::atomic<int> queries{0};
+    std::atomic<int> inconsistent{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&]() {
+            int last_money_in = 0;
+            while (!done.load()) {
+                specific_range_of_transactions_info summary = store.query_range_summary(account_id, range_start, range_end);
+                std::vector<Monthly_rollup> rollups = store.get_monthly_rollups(account_id, year_month, year_month);
+                std::vector<Transaction_info> rows = store.get_monthly_information(account_id, range_start, range_end);
+
+                int rollup_in = rollups.empty() ? 0 : rollups[0].money_in;
+                int rollup_count = rollups.empty() ? 0 : rollups[0].txn_count;
+                if (summary.money_in < last_money_in || summary.money_in % 100 != 0 || rollup_in != rollup_count * 100)
+                    inconsistent++;
+                if (static_cast<int>(rows.size()) * 100 < last_money_in)
+                    inconsistent++;
+                last_money_in = summary.money_in;
+                queries++;
+            }
+        });
+    }
+
+    int balance = 0;
+    int committed = 0;
+    for (int i = 0; i < writes; ++i) {
+        Transaction_info trans = create_transaction_info(
+            account_id, 100, Transaction_type::Income,
+            Transaction_category_need::Other, Transaction_category_want::Other,
+            "Deposit", "", balance, balance + 100);
+        trans.ymd = mid_month;
+        if (store.save_transaction_info(account_id, trans)) {
+            committed++;
+            balance += 100;
+        }
+    }
+    done = true;
+    for (std::thread& reader : readers)
+        reader.join();
+
+    REQUIRE(committed == writes);
+    REQUIRE(inconsistent.load() == 0);
+    REQUIRE(queries.load() > 0);
+    REQUIRE(store.query_range_summary(account_id, range_start, range_end).money_in == writes * 100);
+    REQUIRE(store.get_monthly_rollups(account_id, year_month, year_month)[0].txn_count == writes);
+}
+
+TEST_CASE("transaction projections decode only the requested columns and load notes on demand", "[storage][projection]") {
+    // Startup and summary reads skip the note (and for summaries the name, balances and category);
+    // the note is read the first time a row asks for it and then kept in the cache.
+    Storage store(":memory:");
+    Account acc("Checking", Account_type::checking, 0, true);
+    store.save_account_info(acc);
+    int account_id = acc.read_account_id_in_DB();
+
+    std::time_t jan_1 = 1704067200;
+    Transaction_info rent = create_transaction_info(
+        account_id, -3000, Transaction_type::Need,
+        Transaction_category_need::Housing, Transaction_category_want::Other,
+        "Rent", "paid late", 0, -3000);
+    rent.ymd = jan_1 + 3600;
+    store.save_transaction_info(account_id, rent);
+
+    std::vector<Transaction_info> summary = store.get_monthly_information(account_id, jan_1, jan_1 + 86400, Transaction_columns::summary);
+    REQUIRE(summary.size() == 1u);
+    REQUIRE(summary[0].transaction_amount == -3000);
+    REQUIRE(summary[0].ymd == rent.ymd);
+    REQUIRE(summary[0].type_of_transaction == Transaction_type::Need);
+    REQUIRE(summary[0].transaction_name.empty());
+
+    std::vector<Transaction_info> list = store.get_monthly_information(account_id, jan_1, jan_1 + 86400);
+    REQUIRE(list[0].transaction_name == "Rent");
+    REQUIRE(list[0].transaction_category_need == Transaction_category_need::Housing);
+    REQUIRE(list[0].account_new_amount == -3000);
+    REQUIRE_FALSE(list[0].note_loaded);
+    REQUIRE(list[0].note.empty());
+
+    std::vector<Transaction_info> full = store.get_monthly_information(account_id, jan_1, jan_1 + 86400, Transaction_columns::full);
+    REQUIRE(full[0].note_loaded);
+    REQUIRE(full[0].note == "paid late");
+    REQUIRE(full[0].transaction_category_need == Transaction_category_need::Housing);
+
+    store.load_all_transactions();
+    Transaction_row cached = store.get_transactions(account_id)[0];
+    REQUIRE_FALSE(cached.note_loaded);
+    REQUIRE(cached.transaction_category_need == Transaction_category_need::Housing);
+
+    REQUIRE(store.get_transaction_note(account_id, rent.transaction_id) == "paid late");
+    REQUIRE(store.get_transactions(account_id)[0].note_loaded);
+    REQUIRE(store.get_transaction_note(account_id, rent.transaction_id + 1).empty());
+}
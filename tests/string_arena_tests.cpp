@@ -0,0 +1,43 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/string_arena.h"
+#include <cstring>
+#include <string>
+
+// String_arena unit tests: interning must return one handle per distinct string, and the views it
+// hands out must stay put while more strings are added.
+
+TEST_CASE("String_arena interns equal strings to one handle", "[arena]") {
+    // Recurring names like "Rent" are stored once no matter how many rows use them.
+    String_arena arena;
+    String_arena::Handle rent = arena.intern("Rent");
+    String_arena::Handle groceries = arena.intern("Groceries");
+
+    REQUIRE(arena.intern(std::string("Rent")) == rent);
+    REQUIRE(rent != groceries);
+    REQUIRE(arena.view(rent) == "Rent");
+    REQUIRE(arena.intern("") == 0u);
+    REQUIRE(arena.view(0).empty());
+    REQUIRE(arena.string_count() == 3u);   // "", "Rent", "Groceries"
+}
+
+TEST_CASE("String_arena views stay valid and NUL-terminated as the arena grows", "[arena]") {
+    // Rows hold views across later inserts, and the UI passes data() straight to printf-style calls.
+    String_arena arena;
+    std::string_view first = arena.view(arena.intern("first"));
+    const char* first_data = first.data();
+
+    for (int i = 0; i < 20000; ++i)
+        arena.intern("name " + std::to_string(i));
+    std::string big(200000, 'x');
+    std::string_view big_view = arena.view(arena.intern(big));
+
+    REQUIRE(first.data() == first_data);
+    REQUIRE(std::strcmp(first.data(), "first") == 0);
+    REQUIRE(big_view.size() == big.size());
+    REQUIRE(big_view.data()[big_view.size()] == '\0');
+    REQUIRE(arena.view(arena.intern("name 19999")) == "name 19999");
+
+    arena.clear();
+    REQUIRE(arena.string_count() == 1u);
+    REQUIRE(arena.intern("first") == 1u);
+}
@@ -0,0 +1,139 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/transaction_display.h"
+#include "../src/helpers.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+// Transaction_display_cache tests: the cached text must match what the tables used to format per
+// frame, stay aligned with the store through inserts and deletes, and only format new rows.
+
+namespace
+{
+    Transaction_info make_row(int id, int amount, Transaction_type type, std::time_t ymd)
+    {
+        Transaction_info trans = create_transaction_info(
+            3, amount, type, Transaction_category_need::Food, Transaction_category_want::Other,
+            "Row", "", 0, amount);
+        trans.transaction_id = id;
+        trans.ymd = ymd;
+        return trans;
+    }
+
+    std::string local_date(std::time_t when)
+    {
+        char buf[32];
+        std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M", std::localtime(&when));
+        return buf;
+    }
+
+    void set_timezone(const char* tz)
+    {
+        setenv("TZ", tz, 1);
+        tzset();
+    }
+}
+
+TEST_CASE("Transaction_display_cache formats amounts, dates and type labels once per row", "[display]") {
+    // Amounts are exact cents with an explicit sign, dates are local minutes and the type is the
+    // same label transaction_type_to_string gives; reading again without a change formats nothing.
+    Account_transactions rows;
+    rows.push_back(make_row(1, -1999, Transaction_type::Need, 1704110400));
+    rows.push_back(make_row(2, 250000, Transaction_type::Income, 1704110430));   // same minute
+    rows.push_back(make_row(3, 5, Transaction_type::Gift, 1706788800));
+
+    Transaction_display_cache cache;
+    std::span<const Transaction_text> text = cache.text(3, rows);
+    REQUIRE(text.size() == 3u);
+    REQUIRE(std::strcmp(text[0].amount, "-19.99") == 0);
+    REQUIRE(std::strcmp(text[1].amount, "+2500.00") == 0);
+    REQUIRE(std::strcmp(text[2].amount, "+0.05") == 0);
+    REQUIRE(std::strcmp(text[0].type, "Need") == 0);
+    REQUIRE(std::strcmp(text[2].type, transaction_type_to_string(Transaction_type::Gift)) == 0);
+    REQUIRE(text[0].date == local_date(1704110400));
+    REQUIRE(text[1].date == local_date(1704110430));
+    REQUIRE(text[2].date == local_date(1706788800));
+    REQUIRE(cache.rows_formatted() == 3);
+
+    cache.text(3, rows);
+    REQUIRE(cache.rows_formatted() == 3);
+}
+
+TEST_CASE("Transaction_display_cache keeps existing rows across inserts and deletes", "[display]") {
+    // After a delete and two inserts only the new rows are formatted, and every entry still lines
+    // up with the store row of the same index.
+    Account_transactions rows;
+    for (int id = 1; id <= 5; ++id)
+        rows.push_back(make_row(id, id * 100, Transaction_type::Want, 1704067200 + id * 86400));
+
+    Transaction_display_cache cache;
+    cache.text(3, rows);
+    REQUIRE(cache.rows_formatted() == 5);
+
+    rows.erase(rows.find(2));
+    rows.push_back(make_row(6, -600, Transaction_type::Savings, 1704067200 + 6 * 86400));
+    rows.push_back(make_row(7, 700, Transaction_type::Dividends, 1704067200 + 7 * 86400));
+
+    std::span<const Transaction_text> text = cache.text(3, rows);
+    REQUIRE(cache.rows_formatted() == 7);
+    REQUIRE(text.size() == rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const Transaction_row row = rows[i];
+        char expected[16];
+        std::snprintf(expected, sizeof(expected), "%+d.%02d", row.transaction_amount / 100, std::abs(row.transaction_amount % 100));
+        REQUIRE(std::strcmp(text[i].amount, expected) == 0);
+        REQUIRE(std::strcmp(text[i].type, transaction_type_to_string(row.type_of_transaction)) == 0);
+        REQUIRE(text[i].date == local_date(row.ymd));
+    }
+
+    rows.clear();
+    REQUIRE(cache.text(3, rows).empty());
+}
+
+TEST_CASE("Transaction_display_cache formats a row that reuses a deleted row's id", "[display]") {
+    // SQLite gives a deleted newest row's id to the next insert; the cached text of the deleted
+    // row must not be shown for the new one.
+    Account_transactions rows;
+    rows.push_back(make_row(1, 1000, Transaction_type::Income, 1704067200));
+    rows.push_back(make_row(2, -5000, Transaction_type::Need, 1704067200 + 86400));
+
+    Transaction_display_cache cache;
+    cache.text(3, rows);
+    rows.erase(rows.find(2));
+    rows.push_back(make_row(2, 777, Transaction_type::Income, 1704067200 + 9 * 86400));
+
+    std::span<const Transaction_text> text = cache.text(3, rows);
+    REQUIRE(cache.rows_formatted() == 3);
+    REQUIRE(std::strcmp(text[1].amount, "+7.77") == 0);
+    REQUIRE(std::strcmp(text[1].type, "Income") == 0);
+    REQUIRE(text[1].date == local_date(1704067200 + 9 * 86400));
+}
+
+TEST_CASE("Transaction_display_cache reformats every row after a timezone change", "[display]") {
+    // Dates are local time, so a new timezone invalidates them; refresh_settings notices it and
+    // the next read reformats everything. An unchanged setting is a no-op.
+    const char* saved = std::getenv("TZ");
+    std::string saved_tz = saved ? saved : "";
+    set_timezone("UTC0");
+
+    Account_transactions rows;
+    rows.push_back(make_row(1, 100, Transaction_type::Income, 1704110400));   // 2024-01-01 12:00 UTC
+    Transaction_display_cache cache;
+    REQUIRE(std::strcmp(cache.text(3, rows)[0].date, "2024-01-01 12:00") == 0);
+    REQUIRE_FALSE(cache.refresh_settings());
+
+    set_timezone("EST5EDT");
+    REQUIRE(cache.refresh_settings());
+    REQUIRE(std::strcmp(cache.text(3, rows)[0].date, "2024-01-01 07:00") == 0);
+    REQUIRE(cache.rows_formatted() == 2);
+
+    if (saved)
+        set_timezone(saved_tz.c_str());
+    else
+    {
+        unsetenv("TZ");
+        tzset();
+    }
+}
@@ -0,0 +1,208 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/transaction_store.h"
+#include "../src/helpers.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Account_transactions unit tests: the columnar cache must hand back exactly the rows it was
+// given, in id order, through the same field names Transaction_info uses.
+
+namespace
+{
+    Transaction_info make_row(int id, int amount, Transaction_type type, const std::string& name, const std::string& note)
+    {
+        Transaction_info trans = create_transaction_info(
+            7, amount, type, Transaction_category_need::Food, Transaction_category_want::Travel,
+            name, note, 1000, 1000 + amount);
+        trans.transaction_id = id;
+        trans.ymd = 1704067200 + id * 86400;
+        return trans;
+    }
+}
+
+TEST_CASE("Account_transactions round-trips rows through its columns", "[store]") {
+    // Every field written with push_back must read back unchanged through the row view,
+    // including the category that belongs to the row's type.
+    Account_transactions store;
+    store.push_back(make_row(1, -250, Transaction_type::Need, "Groceries", "weekly shop"));
+    store.push_back(make_row(2, -900, Transaction_type::Want, "Flights", ""));
+    store.push_back(make_row(5, 4000, Transaction_type::Income, "Salary", "March"));
+
+    REQUIRE(store.size() == 3u);
+    REQUIRE_FALSE(store.empty());
+
+    Transaction_row groceries = store[0];
+    REQUIRE(groceries.transaction_id == 1);
+    REQUIRE(groceries.account_id == 7);
+    REQUIRE(groceries.transaction_amount == -250);
+    REQUIRE(groceries.type_of_transaction == Transaction_type::Need);
+    REQUIRE(groceries.transaction_category_need == Transaction_category_need::Food);
+    REQUIRE(groceries.transaction_category_want == Transaction_category_want::Other);
+    REQUIRE(groceries.account_previous_amount == 1000);
+    REQUIRE(groceries.account_new_amount == 750);
+    REQUIRE(groceries.transaction_name == "Groceries");
+    REQUIRE(groceries.note == "weekly shop");
+
+    REQUIRE(store[1].transaction_category_want == Transaction_category_want::Travel);
+    REQUIRE(store[1].transaction_category_need == Transaction_category_need::Other);
+    REQUIRE(store.back().transaction_name == "Salary");
+    REQUIRE(store.front().transaction_id == 1);
+
+    Transaction_info copy = store[2].to_info();
+    REQUIRE(copy.transaction_amount == 4000);
+    REQUIRE(copy.note == "March");
+    REQUIRE(copy.ymd == store.dates()[2]);
+
+    std::vector<int> ids;
+    for (const auto& t : store)
+        ids.push_back(t.transaction_id);
+    REQUIRE(ids == std::vector<int>{1, 2, 5});
+}
+
+TEST_CASE("Account_transactions finds, erases and fills in notes by id", "[store]") {
+    // Deletes and lazy note loads address rows by transaction id; the columns must stay aligned.
+    Account_transactions store;
+    for (int id = 1; id <= 5; ++id)
+        store.push_back(make_row(id * 10, id * 100, Transaction_type::Income, "Row " + std::to_string(id), ""));
+
+    REQUIRE(store.find(30) == 2u);
+    REQUIRE(store.find(31) == store.size());
+
+    store.erase(store.find(30));
+    REQUIRE(store.size() == 4u);
+    REQUIRE(store[2].transaction_id == 40);
+    REQUIRE(store[2].transaction_amount == 400);
+    REQUIRE(store[2].transaction_name == "Row 4");
+    REQUIRE(store.amounts() == std::vector<int>{100, 200, 400, 500});
+
+    Transaction_info unloaded = make_row(60, 1, Transaction_type::Other, "Later", "");
+    unloaded.note_loaded = false;
+    store.push_back(unloaded);
+    size_t index = store.find(60);
+    REQUIRE_FALSE(store[index].note_loaded);
+    store.set_note(index, "filled in");
+    REQUIRE(store[index].note_loaded);
+    REQUIRE(store[index].note == "filled in");
+
+    store.clear();
+    REQUIRE(store.empty());
+    REQUIRE(store.begin() == store.end());
+}
+
+TEST_CASE("Account_transactions date ranges follow back-dated inserts and deletes", "[store]") {
+    // Rows arrive in id order but not in date order; range queries must still see them by date,
+    // with rows on the same date in id order, before and after deletes and bulk appends.
+    Account_transactions store;
+    const std::time_t day = 86400;
+    const std::time_t jan_1 = 1704067200;
+    auto dated = [&](int id, int amount, std::time_t ymd) {
+        Transaction_info trans = make_row(id, amount, Transaction_type::Income, "Row", "");
+        trans.ymd = ymd;
+        return trans;
+    };
+    store.push_back(dated(1, 100, jan_1 + 5 * day));
+    store.push_back(dated(2, 200, jan_1 + 1 * day));    // back-dated
+    store.push_back(dated(3, -300, jan_1 + 5 * day));   // same day as row 1
+    store.push_back(dated(4, 400, jan_1 + 9 * day));
+
+    auto range_ids = [&store](std::time_t start, std::time_t end) {
+        std::vector<int> ids;
+        for (const auto& t : store.in_date_range(start, end))
+            ids.push_back(t.transaction_id);
+        return ids;
+    };
+    REQUIRE(range_ids(jan_1, jan_1 + 10 * day) == std::vector<int>{2, 1, 3, 4});
+    REQUIRE(range_ids(jan_1 + 5 * day, jan_1 + 9 * day) == std::vector<int>{1, 3});
+    REQUIRE(range_ids(jan_1 + 9 * day, jan_1 + 5 * day).empty());
+
+    Account_transactions::Date_range window = store.in_date_range(jan_1 + 5 * day, jan_1 + 10 * day);
+    REQUIRE(window.size() == 3u);
+    REQUIRE(std::vector<int>(window.amounts.begin(), window.amounts.end()) == std::vector<int>{100, -300, 400});
+
+    store.erase(store.find(1));
+    REQUIRE(range_ids(jan_1, jan_1 + 10 * day) == std::vector<int>{2, 3, 4});
+    REQUIRE((*store.in_date_range(jan_1 + 9 * day, jan_1 + 10 * day).begin()).transaction_amount == 400);
+
+    // a bulk append indexed in one go merges with the existing index
+    std::vector<Transaction_info> bulk = {dated(5, 1, jan_1 + 3 * day), dated(6, 2, jan_1), dated(7, 3, jan_1 + 9 * day)};
+    for (const Transaction_info& trans : bulk)
+        store.append(Transaction_row{trans.transaction_id, trans.account_id, trans.transaction_amount, trans.type_of_transaction,
+            trans.transaction_category_need, trans.transaction_category_want, trans.account_previous_amount,
+            trans.account_new_amount, trans.ymd, trans.transaction_name, trans.note, trans.note_loaded});
+    store.index_dates();
+    REQUIRE(range_ids(jan_1, jan_1 + 10 * day) == std::vector<int>{6, 2, 5, 3, 4, 7});
+}
+
+TEST_CASE("Account_transactions running totals match a scan after back-dated inserts and deletes", "[store]") {
+    // Range totals and net_before come from running sums that single inserts and deletes patch in
+    // place; they must always equal a plain scan over the rows.
+    Account_transactions store;
+    const std::time_t jan_1 = 1704067200;
+    const std::time_t hour = 3600;
+    std::uint32_t seed = 7;
+    auto next = [&seed](std::uint32_t bound) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 8) % bound;
+    };
+
+    auto check = [&](std::time_t start, std::time_t end) {
+        std::int64_t in = 0, out = 0, before = 0;
+        for (const auto& t : store) {
+            if (t.ymd >= start && t.ymd < end)
+                (t.transaction_amount > 0 ? in : out) += t.transaction_amount > 0 ? t.transaction_amount : -t.transaction_amount;
+            if (t.ymd < start)
+                before += t.transaction_amount;
+        }
+        Amount_split totals = store.totals_in_date_range(start, end);
+        REQUIRE(totals.money_in == in);
+        REQUIRE(totals.money_out == out);
+        REQUIRE(store.net_before(start) == before);
+    };
+
+    int next_id = 1;
+    for (int step = 0; step < 300; ++step) {
+        if (store.size() > 5 && next(4) == 0) {
+            store.erase(next(static_cast<std::uint32_t>(store.size())));
+        } else {
+            Transaction_info trans = make_row(next_id++, static_cast<int>(next(20001)) - 10000, Transaction_type::Other, "Row", "");
+            trans.ymd = jan_1 + next(2000) * hour;
+            store.push_back(trans);
+        }
+        if (step % 25 == 0) {
+            std::time_t start = jan_1 + next(2000) * hour;
+            check(start, start + next(1000) * hour);
+            check(jan_1, jan_1 + 2000 * hour);
+        }
+    }
+    check(jan_1 - hour, jan_1 + 3000 * hour);
+    check(jan_1 + 500 * hour, jan_1 + 400 * hour);
+}
+
+TEST_CASE("Account_transactions revision changes with the rows, not with loaded notes", "[store]") {
+    // UI text caches are keyed on the revision, so every add, erase and clear must move it, a
+    // lazily loaded note must not, and two stores must never report the same non-zero value.
+    Account_transactions store;
+    Account_transactions other;
+    REQUIRE(store.revision() == 0u);
+
+    Transaction_info unloaded = make_row(1, 100, Transaction_type::Income, "Pay", "");
+    unloaded.note_loaded = false;
+    store.push_back(unloaded);
+    const std::uint64_t after_insert = store.revision();
+    REQUIRE(after_insert != 0u);
+
+    store.set_note(0, "March");
+    REQUIRE(store.revision() == after_insert);
+
+    other.push_back(make_row(1, 100, Transaction_type::Income, "Pay", ""));
+    REQUIRE(other.revision() != after_insert);
+
+    store.push_back(make_row(2, -50, Transaction_type::Need, "Lunch", ""));
+    const std::uint64_t after_second = store.revision();
+    REQUIRE(after_second != after_insert);
+    store.erase(0);
+    REQUIRE(store.revision() != after_second);
+    store.clear();
+    REQUIRE(store.revision() == 0u);
+}
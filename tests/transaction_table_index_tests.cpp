@@ -0,0 +1,235 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/transaction_table_index.h"
+#include "../src/helpers.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Transaction_table_index tests: every query must return exactly what sorting and filtering a
+// copy of the rows would, including after the store gains and loses rows between queries.
+
+namespace
+{
+    const char* names[] = {"Rent", "groceries", "Groceries", "Salary", "bank fee", "Bookshop", ""};
+
+    Transaction_info make_row(int id, std::mt19937& rng)
+    {
+        const Transaction_type type = static_cast<Transaction_type>(rng() % 8);
+        Transaction_info trans = create_transaction_info(
+            4, static_cast<int>(rng() % 20001) - 10000, type,
+            static_cast<Transaction_category_need>(rng() % 8), static_cast<Transaction_category_want>(rng() % 7),
+            names[rng() % 7], "", 0, 0);
+        trans.transaction_id = id;
+        trans.ymd = 1704067200 + static_cast<std::time_t>(rng() % 40) * 86400;   // many rows share a date
+        return trans;
+    }
+
+    std::string lowered(std::string_view text)
+    {
+        std::string out(text);
+        for (char& c : out)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return out;
+    }
+
+    std::string category_of(const Transaction_row& row)
+    {
+        if (row.type_of_transaction == Transaction_type::Need)
+            return transaction_category_need_to_string(row.transaction_category_need);
+        if (row.type_of_transaction == Transaction_type::Want)
+            return transaction_category_want_to_string(row.transaction_category_want);
+        return "";
+    }
+
+    //what the index should return, by sorting and filtering a copy
+    std::vector<std::uint32_t> brute_force(const Account_transactions& rows, const Transaction_query& query)
+    {
+        const Transaction_filter& f = query.filter;
+        std::vector<std::uint32_t> out;
+        for (std::uint32_t i = 0; i < rows.size(); ++i)
+        {
+            const Transaction_row r = rows[i];
+            if (f.type && r.type_of_transaction != *f.type) continue;
+            if (f.need_category && (r.type_of_transaction != Transaction_type::Need || r.transaction_category_need != *f.need_category)) continue;
+            if (f.want_category && (r.type_of_transaction != Transaction_type::Want || r.transaction_category_want != *f.want_category)) continue;
+            if (f.min_amount && r.transaction_amount < *f.min_amount) continue;
+            if (f.max_amount && r.transaction_amount > *f.max_amount) continue;
+            if (f.start && r.ymd < *f.start) continue;
+            if (f.end && r.ymd >= *f.end) continue;
+            if (!f.text.empty() && lowered(r.transaction_name).find(lowered(f.text)) == std::string::npos) continue;
+            out.push_back(i);
+        }
+        auto key_less = [&](std::uint32_t a, std::uint32_t b) {
+            const Transaction_row ra = rows[a], rb = rows[b];
+            switch (query.column)
+            {
+                case Transaction_sort_column::Name:
+                {
+                    std::string la = lowered(ra.transaction_name), lb = lowered(rb.transaction_name);
+                    if (la != lb) return la < lb;
+                    if (ra.transaction_name != rb.transaction_name) return ra.transaction_name < rb.transaction_name;
+                    break;
+                }
+                case Transaction_sort_column::Amount:
+                    if (ra.transaction_amount != rb.transaction_amount) return ra.transaction_amount < rb.transaction_amount;
+                    break;
+                case Transaction_sort_column::Type:
+                {
+                    std::string ta = transaction_type_to_string(ra.type_of_transaction), tb = transaction_type_to_string(rb.type_of_transaction);
+                    if (ta != tb) return ta < tb;
+                    break;
+                }
+                case Transaction_sort_column::Category:
+                    if (category_of(ra) != category_of(rb)) return category_of(ra) < category_of(rb);
+                    break;
+                case Transaction_sort_column::Date:
+                    if (ra.ymd != rb.ymd) return ra.ymd < rb.ymd;
+                    break;
+            }
+            return a < b;
+        };
+        std::sort(out.begin(), out.end(), key_less);
+        if (query.descending)
+            std::reverse(out.begin(), out.end());
+        return out;
+    }
+
+    std::vector<Transaction_query> sample_queries()
+    {
+        std::vector<Transaction_query> queries;
+        for (Transaction_sort_column column : {Transaction_sort_column::Name, Transaction_sort_column::Amount,
+                                               Transaction_sort_column::Type, Transaction_sort_column::Category,
+                                               Transaction_sort_column::Date})
+        {
+            for (bool descending : {false, true})
+            {
+                Transaction_query query;
+                query.column = column;
+                query.descending = descending;
+                queries.push_back(query);
+
+                Transaction_query filtered = query;
+                filtered.filter.type = Transaction_type::Need;
+                filtered.filter.need_category = Transaction_category_need::Food;
+                queries.push_back(filtered);
+
+                filtered = query;
+                filtered.filter.min_amount = -2500;
+                filtered.filter.max_amount = 4000;
+                filtered.filter.start = 1704067200 + 5 * 86400;
+                filtered.filter.end = 1704067200 + 30 * 86400;
+                filtered.filter.text = "GROC";
+                queries.push_back(filtered);
+
+                filtered = query;
+                filtered.filter.want_category = Transaction_category_want::Travel;
+                filtered.filter.text = "o";
+                queries.push_back(filtered);
+            }
+        }
+        return queries;
+    }
+
+    void require_matches_brute_force(Transaction_table_index& index, const Account_transactions& rows)
+    {
+        for (const Transaction_query& query : sample_queries())
+        {
+            std::span<const std::uint32_t> got = index.rows_for(rows, query);
+            std::vector<std::uint32_t> expected = brute_force(rows, query);
+            REQUIRE(std::vector<std::uint32_t>(got.begin(), got.end()) == expected);
+        }
+    }
+}
+
+TEST_CASE("Transaction_table_index sorts and filters like a sort of the copied rows", "[table_index]") {
+    // Every column in both directions, alone and combined with type/category, amount, date and
+    // text filters; ties always fall back to id order so results are deterministic.
+    std::mt19937 rng(7);
+    Account_transactions rows;
+    for (int id = 1; id <= 600; ++id)
+        rows.push_back(make_row(id, rng));
+
+    Transaction_table_index index;
+    require_matches_brute_force(index, rows);
+}
+
+TEST_CASE("Transaction_table_index keeps its permutations across inserts and deletes", "[table_index]") {
+    // After the first query builds the permutations, later changes only merge in the new rows:
+    // the results still match a full sort, and the rows sorted so far grow by the rows added.
+    std::mt19937 rng(11);
+    Account_transactions rows;
+    int next_id = 1;
+    for (; next_id <= 400; ++next_id)
+        rows.push_back(make_row(next_id, rng));
+
+    Transaction_table_index index;
+    require_matches_brute_force(index, rows);
+    const long long sorted_after_build = index.rows_sorted();
+    REQUIRE(sorted_after_build == 4 * 400);   // name, amount, type, category; dates come from the store
+
+    for (int round = 0; round < 5; ++round)
+    {
+        rows.erase(rng() % rows.size());
+        rows.erase(rng() % rows.size());
+        for (int added = 0; added < 3; ++added)
+            rows.push_back(make_row(next_id++, rng));
+        require_matches_brute_force(index, rows);
+    }
+    REQUIRE(index.rows_sorted() == sorted_after_build + 4 * 5 * 3);
+
+    // appends alone extend the current filter's bitmap instead of recomputing it
+    Transaction_query filtered;
+    filtered.column = Transaction_sort_column::Name;
+    filtered.filter.text = "GROC";
+    filtered.filter.max_amount = 0;
+    index.rows_for(rows, filtered);
+    for (int added = 0; added < 20; ++added)
+    {
+        rows.push_back(make_row(next_id++, rng));
+        std::span<const std::uint32_t> got = index.rows_for(rows, filtered);
+        REQUIRE(std::vector<std::uint32_t>(got.begin(), got.end()) == brute_force(rows, filtered));
+    }
+
+    rows.clear();
+    Transaction_query query;
+    REQUIRE(index.rows_for(rows, query).empty());
+}
+
+TEST_CASE("Transaction_table_index treats a re-inserted id as a new row", "[table_index]") {
+    // SQLite gives a deleted newest row's id to the next insert. The row under that id is a
+    // different one, so its sort position and type bits must come from the new row, whether or
+    // not the index looked at the rows in between.
+    for (bool query_between : {false, true})
+    {
+        std::mt19937 rng(5);
+        Account_transactions rows;
+        for (int id = 1; id <= 50; ++id)
+            rows.push_back(make_row(id, rng));
+        Transaction_info newest = create_transaction_info(4, -5000, Transaction_type::Need,
+            Transaction_category_need::Food, Transaction_category_want::Other, "groceries", "", 0, 0);
+        newest.transaction_id = 51;
+        newest.ymd = 1704067200;
+        rows.push_back(newest);
+
+        Transaction_table_index index;
+        require_matches_brute_force(index, rows);
+
+        rows.erase(rows.size() - 1);
+        if (query_between)
+            require_matches_brute_force(index, rows);
+        Transaction_info reused = create_transaction_info(4, 777, Transaction_type::Income,
+            Transaction_category_need::Other, Transaction_category_want::Other, "Salary", "", 0, 0);
+        reused.transaction_id = 51;
+        reused.ymd = 1704067200 + 39 * 86400;
+        rows.push_back(reused);
+
+        require_matches_brute_force(index, rows);
+        Transaction_query needs;
+        needs.filter.type = Transaction_type::Need;
+        std::span<const std::uint32_t> got = index.rows_for(rows, needs);
+        REQUIRE(std::find(got.begin(), got.end(), static_cast<std::uint32_t>(rows.size() - 1)) == got.end());
+    }
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/wallet.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Wallet unit tests: snapshots are immutable and survive later publishes, and a patch copies only
+// the account it changes.
+
+namespace
+{
+    Account_info make_account(int id, int money, bool is_asset = true)
+    {
+        Account_info acc{};
+        acc.account_id = id;
+        acc.money_amount = money;
+        acc.account_name = "Account " + std::to_string(id);
+        acc.account_type = "Checking";
+        acc.is_asset = is_asset;
+        return acc;
+    }
+}
+
+TEST_CASE("Wallet put replaces or appends an account and remove drops one", "[wallet]") {
+    // These are how the controller applies created, edited and deleted accounts without a reload.
+    Wallet wallet;
+    wallet.publish({make_account(1, 100), make_account(2, 200)});
+
+    Account_info renamed = make_account(2, 250);
+    renamed.account_name = "Renamed";
+    wallet.put(renamed);
+    wallet.put(make_account(3, 300));
+    REQUIRE(wallet.size() == 3u);
+    REQUIRE(wallet[1].account_name == "Renamed");
+    REQUIRE(wallet[2].money_amount == 300);
+
+    REQUIRE(wallet.remove(1));
+    REQUIRE_FALSE(wallet.remove(1));
+    REQUIRE(wallet.size() == 2u);
+    REQUIRE(wallet[0].account_id == 2);
+}
+
+TEST_CASE("Wallet snapshots stay unchanged while patches publish new ones", "[wallet]") {
+    // A reader holding a snapshot keeps seeing the old balances; the new snapshot shares every
+    // account the patch did not touch.
+    Wallet wallet;
+    REQUIRE(wallet.empty());
+    wallet.publish({make_account(1, 100), make_account(2, 200), make_account(3, 300)});
+
+    std::shared_ptr<const Wallet_snapshot> before = wallet.snapshot();
+    REQUIRE(wallet.patch(2, [](Account_info& acc) { acc.money_amount = 250; }));
+    REQUIRE_FALSE(wallet.patch(9, [](Account_info& acc) { acc.money_amount = 0; }));
+    std::shared_ptr<const Wallet_snapshot> after = wallet.snapshot();
+
+    REQUIRE((*before)[1].money_amount == 200);
+    REQUIRE((*after)[1].money_amount == 250);
+    REQUIRE(wallet[1].money_amount == 250);
+    REQUIRE(before->entries()[0] == after->entries()[0]);
+    REQUIRE(before->entries()[2] == after->entries()[2]);
+    REQUIRE(before->entries()[1] != after->entries()[1]);
+    REQUIRE(after->find(3)->money_amount == 300);
+    REQUIRE(after->find(4) == nullptr);
+
+    int total = 0;
+    for (const Account_info& acc : *after)
+        total += acc.money_amount;
+    REQUIRE(total == 650);
+}
+
+TEST_CASE("Wallet patches from several threads are all kept", "[wallet]") {
+    // Concurrent writers each retry on top of the other's snapshot, so no increment is lost,
+    // and readers on another thread only ever see complete snapshots.
+    Wallet wallet;
+    wallet.publish({make_account(1, 0), make_account(2, 0)});
+
+    std::atomic<bool> done{false};
+    std::atomic<bool> saw_partial{false};
+    std::thread reader([&]() {
+        while (!done.load()) {
+            std::shared_ptr<const Wallet_snapshot> snapshot = wallet.snapshot();
+            if (snapshot->size() != 2u)
+                saw_partial = true;
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 4; ++w) {
+        writers.emplace_back([&wallet, w]() {
+            for (int i = 0; i < 500; ++i)
+                wallet.patch(1 + w % 2, [](Account_info& acc) { acc.money_amount += 1; });
+        });
+    }
+    for (std::thread& writer : writers)
+        writer.join();
+    done = true;
+    reader.join();
+
+    REQUIRE_FALSE(saw_partial.load());
+    REQUIRE(wallet[0].money_amount == 1000);
+    REQUIRE(wallet[1].money_amount == 1000);
+}
@@ -0,0 +1,161 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/allocation_counter.h"
+#include "../src/storage.h"
+#include "../src/write_pipeline.h"
+#include "../src/app_controller.h"
+#include "../src/future_app_state.h"
+#include "../src/core_logic.h"
+#include "../src/helpers.h"
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Heap allocations on the transaction write path, counted by src/allocation_counter.cpp's
+// operator new across every thread (a pipeline save allocates on the writer thread too); each test
+// reads the counter around the calls it measures. SQLite's own memory goes through its allocator,
+// not operator new, and is not counted.
+
+namespace
+{
+    // long enough that any std::string copy of them has to allocate
+    const char* long_name = "Weekly groceries at the corner market";
+    const char* long_note = "split with a flatmate, paid back by bank transfer";
+
+    Transaction_info make_row(int account_id, int previous_balance = 0)
+    {
+        return create_transaction_info(account_id, -1250, Transaction_type::Need,
+            Transaction_category_need::Food, Transaction_category_want::Other,
+            long_name, long_note, previous_balance, previous_balance - 1250);
+    }
+}
+
+TEST_CASE("create_transaction_info moves its strings in", "[allocations][helpers]") {
+    // The by-value name and note are moved into the Transaction_info, so a caller handing over
+    // its own strings pays for no copy.
+    std::string name = long_name;
+    std::string note = long_note;
+
+    long long before = total_allocation_count();
+    Transaction_info trans = create_transaction_info(1, 500, Transaction_type::Income,
+        Transaction_category_need::Other, Transaction_category_want::Other,
+        std::move(name), std::move(note), 0, 500);
+    long long allocations = total_allocation_count() - before;
+
+    REQUIRE(allocations == 0);
+    REQUIRE(trans.transaction_name == long_name);
+    REQUIRE(trans.note == long_note);
+}
+
+TEST_CASE("saving a moved transaction allocates nothing once the cache has room", "[allocations][storage]") {
+    // The row moves through to the change-set, text is bound without copying, and a name already
+    // interned costs the cache nothing; the only copy a new name makes is its arena entry.
+    Storage store(":memory:");
+    Account acc("Checking", Account_type::checking, 100000, true);
+    store.save_account_info(acc);
+    int account_id = acc.read_account_id_in_DB();
+
+    store.save_transaction_info(account_id, make_row(account_id, 100000));   // prepares the statements, interns the strings
+    const int saves = 20;
+    store.reserve_transactions(account_id, saves + 1);
+    std::vector<Transaction_info> rows;
+    for (int i = 1; i <= saves; ++i)
+        rows.push_back(make_row(account_id, 100000 - 1250 * i));
+
+    long long before = total_allocation_count();
+    int committed = 0;
+    for (Transaction_info& trans : rows)
+    {
+        std::optional<Storage_changes> changes = store.save_transaction_info(account_id, std::move(trans));
+        if (changes && changes->inserted.size() == 1 && changes->inserted[0].transaction_name == long_name)
+            ++committed;
+    }
+    long long allocations = total_allocation_count() - before;
+
+    REQUIRE(committed == saves);
+    REQUIRE(allocations == 0);
+    const Account_transactions& cached = store.get_transactions(account_id);
+    REQUIRE(cached.size() == static_cast<size_t>(saves + 1));
+    REQUIRE(cached.back().transaction_name == long_name);
+    REQUIRE(cached.back().note == long_note);
+    REQUIRE(store.load_accounts()[0].money_amount == 100000 - 1250 * (saves + 1));
+}
+
+TEST_CASE("a moved internal transfer copies its strings once, for the second row", "[allocations][storage][transfer]") {
+    // Both rows need their own name and note; the destination row takes the caller's strings,
+    // so only the source row's copy allocates.
+    Storage store(":memory:");
+    Account from_acc("From", Account_type::checking, 100000, true);
+    Account to_acc("To", Account_type::savings, 0, true);
+    store.save_account_info(from_acc);
+    store.save_account_info(to_acc);
+    int from_id = from_acc.read_account_id_in_DB();
+    int to_id = to_acc.read_account_id_in_DB();
+
+    store.save_internal_transfer(from_id, to_id, make_row(from_id));
+    const int transfers = 10;
+    store.reserve_transactions(from_id, transfers + 1);
+    store.reserve_transactions(to_id, transfers + 1);
+    std::vector<Transaction_info> rows;
+    for (int i = 0; i < transfers; ++i)
+        rows.push_back(make_row(from_id));
+
+    long long before = total_allocation_count();
+    int committed = 0;
+    for (Transaction_info& trans : rows)
+    {
+        if (store.save_internal_transfer(from_id, to_id, std::move(trans)))
+            ++committed;
+    }
+    long long allocations = total_allocation_count() - before;
+
+    REQUIRE(committed == transfers);
+    REQUIRE(allocations == 2 * transfers);
+    REQUIRE(store.get_transactions(to_id).size() == static_cast<size_t>(transfers + 1));
+    REQUIRE(store.get_transactions(to_id).back().note == long_note);
+}
+
+TEST_CASE("a save through the Controller's Write_pipeline costs two std::function objects and two wallet publishes", "[allocations][pipeline]") {
+    // Queued, a save is a Command for the writer and a Completion back to the UI thread; each
+    // captures more than std::function holds inline, so each allocates once. The wallet is
+    // republished twice (the optimistic balance, then the committed one) at three allocations
+    // each. The writer keeps no cache of its own and the UI cache takes the row without copying
+    // its interned strings; beyond that only a queue growing by a deque block allocates.
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "pbudget_pipeline_allocations.db";
+    for (const char* suffix : {"", "-wal", "-shm", "-journal"})
+        std::filesystem::remove(path.string() + suffix);
+    Storage store(path.string(), Storage_options::fast_interactive());
+    Write_pipeline pipeline(path.string(), Storage_options::fast_interactive());
+    App_state state;
+    Controller ctrl(state, store, &pipeline);
+    Account acc("Checking", Account_type::checking, 100000, true);
+    ctrl.create_account(acc);
+    int account_id = state.wallet[0].account_id;
+
+    Transaction_info first = make_row(account_id, 100000);
+    ctrl.create_transaction(account_id, first);   // prepares the writer's statements, interns the strings
+    ctrl.flush_writes();
+    const int saves = 20;
+    store.reserve_transactions(account_id, saves + 1);
+    std::vector<Transaction_info> rows;
+    for (int i = 1; i <= saves; ++i)
+        rows.push_back(make_row(account_id, 100000 - 1250 * i));
+
+    // the per-frame poll with nothing committed must be free
+    long long before = total_allocation_count();
+    for (int frame = 0; frame < 10; ++frame)
+        ctrl.process_completions();
+    REQUIRE(total_allocation_count() - before == 0);
+
+    before = total_allocation_count();
+    for (Transaction_info& trans : rows)
+        ctrl.create_transaction(account_id, trans);
+    ctrl.flush_writes();
+    long long allocations = total_allocation_count() - before;
+
+    REQUIRE(allocations >= 8 * saves);
+    REQUIRE(allocations - 8 * saves <= 4);
+    REQUIRE(ctrl.get_transactions(account_id).size() == static_cast<size_t>(saves + 1));
+    REQUIRE(ctrl.get_transactions(account_id).back().note == long_note);
+    REQUIRE(state.wallet[0].money_amount == 100000 - 1250 * (saves + 1));
+}
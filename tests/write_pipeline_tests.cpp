@@ -0,0 +1,209 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/write_pipeline.h"
+#include "../src/app_controller.h"
+#include "../src/future_app_state.h"
+#include "../src/storage.h"
+#include "../src/core_logic.h"
+#include "../src/helpers.h"
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Write_pipeline tests. The writer thread needs its own connection to the same database, so
+// these use a temp file instead of ":memory:".
+
+namespace
+{
+    std::string fresh_db_path(const char* name) {
+        std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+        for (const char* suffix : {"", "-wal", "-shm", "-journal"})
+            std::filesystem::remove(path.string() + suffix);
+        return path.string();
+    }
+}
+
+TEST_CASE("Write_pipeline runs commands in order and hands completions to the caller's thread", "[pipeline]") {
+    // Commands execute on the writer thread in submission order; their completions must wait for
+    // process_completions() so App_state is only ever touched from the UI thread.
+    std::string path = fresh_db_path("pbudget_pipeline_order.db");
+    Write_pipeline pipeline(path, Storage_options::fast_interactive());
+
+    const std::thread::id ui_thread = std::this_thread::get_id();
+    std::vector<int> order;
+    std::vector<int> applied;
+    bool completion_on_ui_thread = true;
+
+    for (int i = 0; i < 5; ++i) {
+        pipeline.submit([&, i](Storage&) -> Write_pipeline::Completion {
+            order.push_back(i);
+            return [&, i]() {
+                completion_on_ui_thread = completion_on_ui_thread && std::this_thread::get_id() == ui_thread;
+                applied.push_back(i);
+            };
+        });
+    }
+
+    pipeline.flush();
+
+    REQUIRE(order == std::vector<int>{0, 1, 2, 3, 4});
+    REQUIRE(applied == std::vector<int>{0, 1, 2, 3, 4});
+    REQUIRE(completion_on_ui_thread);
+
+    Write_pipeline_stats stats = pipeline.stats();
+    REQUIRE(stats.queue_depth == 0u);
+    REQUIRE(stats.completions_pending == 0u);
+    REQUIRE(stats.commands_committed == 5);
+    REQUIRE(stats.max_commit_ms >= stats.average_commit_ms);
+}
+
+TEST_CASE("Controller with a Write_pipeline applies committed writes without reloading", "[pipeline][controller]") {
+    // With a pipeline the controller enqueues writes and patches App_state optimistically;
+    // once flushed, the UI-side cache and wallet must match what a fresh load from disk returns.
+    std::string path = fresh_db_path("pbudget_pipeline_controller.db");
+    Storage store(path, Storage_options::fast_interactive());
+    Write_pipeline pipeline(path, Storage_options::fast_interactive());
+    App_state state;
+    Controller ctrl(state, store, &pipeline);
+
+    Account checking("Checking", Account_type::checking, 10000, true);
+    ctrl.create_account(checking);
+    Account savings("Savings", Account_type::savings, 0, true);
+    ctrl.create_account(savings);
+    int checking_id = state.wallet[0].account_id;
+    int savings_id = state.wallet[1].account_id;
+
+    Transaction_info pay = create_transaction_info(
+        checking_id, 5000, Transaction_type::Income,
+        Transaction_category_need::Other, Transaction_category_want::Other,
+        "Pay", "", 10000, 15000);
+    ctrl.create_transaction(checking_id, pay);
+    REQUIRE(state.wallet[0].money_amount == 15000);   // optimistic, before the commit
+
+    Transaction_info move = create_transaction_info(
+        checking_id, 2000, Transaction_type::Internal_transfer,
+        Transaction_category_need::Other, Transaction_category_want::Other,
+        "To savings", "", 0, 0);
+    ctrl.create_internal_transfer(checking_id, savings_id, move);
+    REQUIRE(state.wallet[0].money_amount == 13000);
+    REQUIRE(state.wallet[1].money_amount == 2000);
+
+    ctrl.flush_writes();
+
+    const Account_transactions& checking_rows = ctrl.get_transactions(checking_id);
+    REQUIRE(checking_rows.size() == 2u);
+    REQUIRE(checking_rows[0].transaction_id > 0);
+    REQUIRE(ctrl.get_transactions(savings_id).size() == 1u);
+
+    std::time_t month_start = checking_rows[0].ymd - 86400;
+    std::time_t month_end = checking_rows[0].ymd + 86400;
+    specific_range_of_transactions_info before_delete = ctrl.get_monthly_summary(checking_id, month_start, month_end);
+    REQUIRE(before_delete.money_in == 5000);
+    REQUIRE(before_delete.money_out == 2000);
+
+    ctrl.delete_transaction(checking_rows[0].transaction_id, checking_id);
+    ctrl.flush_writes();
+
+    REQUIRE(ctrl.get_transactions(checking_id).size() == 1u);
+    REQUIRE(state.wallet[0].money_amount == 8000);
+    REQUIRE(ctrl.get_monthly_summary(checking_id, month_start, month_end).money_in == 0);
+
+    Storage reopened(path);
+    std::vector<Account_info> on_disk = reopened.load_accounts();
+    REQUIRE(on_disk[0].money_amount == state.wallet[0].money_amount);
+    REQUIRE(on_disk[1].money_amount == state.wallet[1].money_amount);
+    reopened.load_all_transactions();
+    REQUIRE(reopened.get_transactions(checking_id).size() == 1u);
+    REQUIRE(reopened.get_transactions(checking_id)[0].transaction_id == ctrl.get_transactions(checking_id)[0].transaction_id);
+}
+
+TEST_CASE("Controller with a Write_pipeline keeps a delete queued ahead of a create in the balance", "[pipeline][controller]") {
+    // The form computes the new row's balance from the wallet, which does not yet show a delete
+    // still in the queue. The writer applies the amount to the stored balance instead of storing
+    // that figure, so the delete survives and wallet, rows and disk agree.
+    std::string path = fresh_db_path("pbudget_pipeline_delete_create.db");
+    Storage store(path, Storage_options::fast_interactive());
+    Write_pipeline pipeline(path, Storage_options::fast_interactive());
+    App_state state;
+    Controller ctrl(state, store, &pipeline);
+
+    Account checking("Checking", Account_type::checking, 100000, true);
+    ctrl.create_account(checking);
+    int checking_id = state.wallet[0].account_id;
+
+    Transaction_info first = create_transaction_info(
+        checking_id, -1000, Transaction_type::Want,
+        Transaction_category_need::Other, Transaction_category_want::Other,
+        "Coffee beans", "", 100000, 99000);
+    ctrl.create_transaction(checking_id, first);
+    ctrl.flush_writes();
+    REQUIRE(state.wallet[0].money_amount == 99000);
+    int first_id = ctrl.get_transactions(checking_id)[0].transaction_id;
+
+    ctrl.delete_transaction(first_id, checking_id);
+    int shown = state.wallet[0].money_amount;   // still 99000: the delete has not completed
+    Transaction_info second = create_transaction_info(
+        checking_id, -500, Transaction_type::Want,
+        Transaction_category_need::Other, Transaction_category_want::Other,
+        "Bus ticket", "", shown, shown - 500);
+    ctrl.create_transaction(checking_id, second);
+    ctrl.flush_writes();
+
+    REQUIRE(state.wallet[0].money_amount == 99500);
+    const Account_transactions& rows = ctrl.get_transactions(checking_id);
+    REQUIRE(rows.size() == 1u);
+    REQUIRE(rows[0].account_previous_amount == 100000);
+    REQUIRE(rows[0].account_new_amount == 99500);
+
+    Storage reopened(path);
+    REQUIRE(reopened.load_accounts()[0].money_amount == 99500);
+}
+
+TEST_CASE("A month summary read between a pipeline commit and its completion is not counted twice", "[pipeline][summary]") {
+    // Without load_all_transactions the summary of a month is read once and kept. If that read
+    // happens after the writer committed but before the completion ran, it already includes the
+    // row, so the completion must not add the row to it again.
+    std::string path = fresh_db_path("pbudget_pipeline_summary.db");
+    Storage store(path, Storage_options::fast_interactive());
+    Write_pipeline pipeline(path, Storage_options::fast_interactive());
+    App_state state;
+    Controller ctrl(state, store, &pipeline);
+
+    Account checking("Checking", Account_type::checking, 0, true);
+    ctrl.create_account(checking);
+    int checking_id = state.wallet[0].account_id;
+
+    Transaction_info pay = create_transaction_info(
+        checking_id, 700, Transaction_type::Income,
+        Transaction_category_need::Other, Transaction_category_want::Other,
+        "Refund", "", 0, 700);
+    pay.ymd = time_from_year_month(202403) + 86400;
+    ctrl.create_transaction(checking_id, pay);
+    while (pipeline.stats().completions_pending == 0)
+        std::this_thread::yield();
+
+    std::time_t march = time_from_year_month(202403);
+    std::time_t april = time_from_year_month(202404);
+    REQUIRE(ctrl.get_monthly_summary(checking_id, march, april).money_in == 700);
+    ctrl.process_completions();
+    REQUIRE(ctrl.get_monthly_summary(checking_id, march, april).money_in == 700);
+}
+
+TEST_CASE("Write_pipeline notifies once per queued completion so a sleeping UI loop wakes", "[pipeline]") {
+    // The notifier runs on the writer thread after each completion is queued; commands that
+    // return no completion have nothing for the UI to apply and do not notify.
+    std::string path = fresh_db_path("pbudget_pipeline_notify.db");
+    Write_pipeline pipeline(path, Storage_options::fast_interactive());
+    std::atomic<int> notified{0};
+    pipeline.set_completion_notifier([&notified]() { notified++; });
+
+    int applied = 0;
+    for (int i = 0; i < 3; ++i)
+        pipeline.submit([&applied](Storage&) -> Write_pipeline::Completion { return [&applied]() { applied++; }; });
+    pipeline.submit([](Storage&) -> Write_pipeline::Completion { return nullptr; });
+    pipeline.flush();
+
+    REQUIRE(applied == 3);
+    REQUIRE(notified == 3);
+}